@@ -1,14 +1,63 @@
 /*Acceloremeter reading functionality*/
+#define _GNU_SOURCE // Needed for clock_gettime
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
 #include <stdlib.h>  
+#include <time.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <math.h>
 #include "accelRead.h" 
 
+#define ACCEL_POLL_TIMEOUT_MS 100   // How long the reader waits before checking whether to stop
+#define ACCEL_IDLE_NS 10000000      // Pause when the device has nothing new (12.5 Hz = 80 ms per sample)
+#define PI_F 3.14159265f
+#define ACCEL_MAX_REPORTS 32        // The shortest report is 10 bytes, so 256 bytes hold at most 25
+
+// One report from the device, a line of the form "ready x y z scale"
+typedef struct {
+    int ready;              // 0 if nothing has changed since the last report
+    int x, y, z;
+    int scale;
+    int magnitude;          // abs(x) + abs(y) + abs(z)
+} AccelReport;
+
+// State of a report being parsed, kept between reads so a report split
+// across two reads is still put together
+typedef struct {
+    int fields[5];
+    int count;              // Fields completed so far
+    int value;              // Field being parsed
+    int negative;
+    int digits;             // Digits in the field being parsed
+    int bad;                // Unexpected character or too many fields, drop the report
+} AccelParser;
+
+static atomic_bool accel_running = false;
+static pthread_t accel_thread;
+static int accel_fd = -1;
+static float accel_rate;
+
+// Shake detector state, only touched by the reader thread. What the game sees
+// is shake_state: bit 0 while shaking, bit 1 once a shake has started, until read.
+static struct {
+    float alpha, beta;      // Filter coefficients for the sample rate
+    int prev[3];            // Previous raw sample
+    float hp[3];            // High-passed x, y and z
+    float energy;           // Windowed average of abs(hp x) + abs(hp y) + abs(hp z)
+    bool shaking;
+    bool primed;            // prev holds a sample
+} shake;
+static _Atomic unsigned int shake_state = 0;
+
 // Function to open and initialize the accelerometer
-int open_accel(void) {
+int open_accel(const char *rate, int range) {
+    char command[32];
     int fd = open(ACCEL_DEVICE_PATH, O_RDWR);
 
     // Check if the file opened successfully
@@ -31,15 +80,18 @@ int open_accel(void) {
         return -1;
     }
 
-    // Set the rate to 12.5 Hz
-    if (write(fd, "rate 12.5", strlen("rate 12.5")) == -1) {
+    // Set the sample rate
+    snprintf(command, sizeof(command), "rate %s", rate);
+    if (write(fd, command, strlen(command)) == -1) {
         perror("Failed to set rate");
         close(fd);
         return -1;
     }
+    accel_rate = atof(rate);
 
-    // Set resolution to 16g
-    if (write(fd, "format 1 16", strlen("format 1 16")) == -1) {
+    // Set full resolution and the range
+    snprintf(command, sizeof(command), "format 1 %d", range);
+    if (write(fd, command, strlen(command)) == -1) {
         perror("Failed to set resolution");
         close(fd);
         return -1;
@@ -57,54 +109,181 @@ int close_accel(int fd) {
     return -1;  // Return failure if the file descriptor is invalid
 }
 
-// Function to read acceleration data and return the magnitude
-int read_accel(int fd) {
+// Function to reset a parser
+static void accel_parser_init(AccelParser *parser) {
+    parser->count = 0;
+    parser->value = 0;
+    parser->negative = 0;
+    parser->digits = 0;
+    parser->bad = 0;
+}
+
+// Function to parse device output a byte at a time, storing up to max_reports
+// complete reports, returns how many were stored. Fields are separated by
+// spaces and a report ends at a newline (or the NUL the driver may add).
+// Malformed reports are skipped. Does no allocation and no stdio.
+static int accel_parse(AccelParser *parser, const char *data, int len,
+                       AccelReport *reports, int max_reports) {
+    int stored = 0;
+    int i;
+    char c;
+
+    for (i = 0; i < len; i++) {
+        c = data[i];
+        if (c >= '0' && c <= '9') {
+            parser->value = parser->value * 10 + (c - '0');
+            parser->digits++;
+            continue;
+        }
+        if (c == '-' && parser->digits == 0 && !parser->negative) {
+            parser->negative = 1;
+            continue;
+        }
+
+        // Anything else ends the field being parsed, if there is one
+        if (parser->digits) {
+            if (parser->count < 5) {
+                parser->fields[parser->count++] = parser->negative ? -parser->value : parser->value;
+            } else {
+                parser->bad = 1;
+            }
+        } else if (parser->negative) {
+            parser->bad = 1;
+        }
+        parser->value = 0;
+        parser->negative = 0;
+        parser->digits = 0;
+
+        if (c == '\n' || c == '\0') {
+            if (parser->count == 5 && !parser->bad && stored < max_reports) {
+                AccelReport *report = &reports[stored++];
+                report->ready = parser->fields[0];
+                report->x = parser->fields[1];
+                report->y = parser->fields[2];
+                report->z = parser->fields[3];
+                report->scale = parser->fields[4];
+                report->magnitude = abs(report->x) + abs(report->y) + abs(report->z);
+            }
+            parser->count = 0;
+            parser->bad = 0;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            parser->bad = 1;
+        }
+    }
+    return stored;
+}
+
+// Function to run one sample through the shake detector
+static void update_shake(int x, int y, int z) {
+    int v[3] = { x, y, z };
+    float sum = 0.0f;
+    int i;
+
+    if (!shake.primed) {
+        memcpy(shake.prev, v, sizeof(v));
+        shake.primed = true;
+        return;
+    }
+
+    for (i = 0; i < 3; i++) {
+        shake.hp[i] = shake.alpha * (shake.hp[i] + v[i] - shake.prev[i]);
+        shake.prev[i] = v[i];
+        sum += fabsf(shake.hp[i]);
+    }
+    shake.energy += shake.beta * (sum - shake.energy);
+
+    if (!shake.shaking && shake.energy >= SHAKE_ON_COUNTS) {
+        shake.shaking = true;
+        atomic_store_explicit(&shake_state, 3, memory_order_relaxed);
+    } else if (shake.shaking && shake.energy < SHAKE_OFF_COUNTS) {
+        shake.shaking = false;
+        atomic_fetch_and_explicit(&shake_state, ~1u, memory_order_relaxed);
+    }
+}
+
+// Function to wait for readings with poll() and check each new one for
+// shaking. The device reports "ready x y z scale", where ready is 0 if
+// nothing has changed since the last read.
+static void *accel_reader_thread(void *arg) {
+    struct pollfd pfd = { .fd = accel_fd, .events = POLLIN };
+    struct timespec idle = { 0, ACCEL_IDLE_NS };
+    AccelParser parser;
+    AccelReport reports[ACCEL_MAX_REPORTS];
     char buffer[256];
-    int x, y, z, scale, deviceID;
-    int magnitude;
+    int count, fresh, i;
+    bool have_sample = false;
+    ssize_t bytesRead;
 
-    if (fd == -1) {
-        perror("Device not open");
-        return -1;  // Return error if the device is not open
+    accel_parser_init(&parser);
+
+    while (atomic_load_explicit(&accel_running, memory_order_relaxed)) {
+        if (poll(&pfd, 1, ACCEL_POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+        bytesRead = read(accel_fd, buffer, sizeof(buffer));
+        if (bytesRead <= 0) {
+            if (bytesRead == -1 && errno != EAGAIN && errno != EINTR) {
+                perror("Failed to read from device");
+                break;
+            }
+            continue;
+        }
+
+        // Every new report goes through the shake detector
+        count = accel_parse(&parser, buffer, bytesRead, reports, ACCEL_MAX_REPORTS);
+        fresh = 0;
+        for (i = 0; i < count; i++) {
+            if (reports[i].ready || !have_sample) {
+                update_shake(reports[i].x, reports[i].y, reports[i].z);
+                have_sample = true;
+                fresh = 1;
+            }
+        }
+        if (!fresh) {
+            // The device always polls readable, so wait a little for new data
+            nanosleep(&idle, NULL);
+        }
     }
+    return NULL;
+}
 
-    // Read the data from the accelerometer
-    ssize_t bytesRead = read(fd, buffer, sizeof(buffer) - 1);
-    if (bytesRead == -1) {
-        perror("Failed to read from device");
-        return -1;  // Return error on read failure
+// Function to start the background reader
+int accel_start(int fd) {
+    if (fd == -1) {
+        return -1;
     }
+    accel_fd = fd;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    // One-pole high-pass and averaging coefficients for the sample period
+    float dt = 1.0f / (accel_rate > 0.0f ? accel_rate : 12.5f);
+    shake.alpha = 1.0f / (1.0f + 2.0f * PI_F * SHAKE_CUTOFF_HZ * dt);
+    shake.beta = dt / (SHAKE_WINDOW_S + dt);
+    shake.primed = false;
+    shake.shaking = false;
+    shake.energy = 0.0f;
 
-    // Null-terminate the buffer to print it as a string
-    buffer[bytesRead] = '\0';
-   // printf("Buffer: %s\n", buffer);
-    //printf("bytesRead: %d", bytesRead);
-    // Read the data from the accelerometer
-
-    // Parse the x, y, z, and scale values as integers
-    if (sscanf(buffer, "%d %d %d %d %d", &deviceID, &x, &y, &z, &scale) == 5) {
-        // Calculate the magnitude as the sum of the absolute values of x, y, and z
-        magnitude = abs(x) + abs(y) + abs(z);
-        return magnitude;  // Return the magnitude
-    } else {
-        //perror("Failed to parse values from the data string");
-        return -1;  // Return error if parsing fails
+    atomic_store(&accel_running, true);
+    if (pthread_create(&accel_thread, NULL, accel_reader_thread, NULL) != 0) {
+        perror("Failed to start accelerometer thread");
+        atomic_store(&accel_running, false);
+        return -1;
     }
+    return 0;
+}
 
-/*
-    int attempt = 0;
-    while (sscanf(buffer, "%d %d %d %d %d", &deviceID, &x, &y, &z, &scale) != 5 && attempt < 5) {
-        attempt++;
-        usleep(5000);  // Sleep for 5 milliseconds
+// Function to check for shaking since the last call
+int accel_shaken(void) {
+    if (!atomic_load_explicit(&accel_running, memory_order_relaxed)) {
+        return -1;
     }
+    // Keep the shaking bit, clear the one that latched the start of a shake
+    return atomic_fetch_and_explicit(&shake_state, 1, memory_order_relaxed) != 0;
+}
 
-    // Parse the x, y, z, and scale values as integers
-    if (attempt == 5) {
-        magnitude = abs(x) + abs(y) + abs(z);
-        return magnitude;  // Return the magnitude
-    } else {
-        perror("Failed to parse values from the data string");
-        return -1;  // Return error if parsing fails
+// Function to stop the background reader
+void accel_stop(void) {
+    if (atomic_exchange(&accel_running, false)) {
+        pthread_join(accel_thread, NULL);
     }
-    */
 }
@@ -4,13 +4,38 @@
 // Define the device path for the accelerometer
 #define ACCEL_DEVICE_PATH "/dev/IntelFPGAUP/accel"
 
-// Function to open and initialize the accelerometer, returns file descriptor
-int open_accel(void);
+// Defaults for the sample rate (Hz, one of the rates the ADXL345 supports)
+// and the range (2, 4, 8 or 16 g). Samples are always full resolution,
+// 3.9 mg per count, whatever the range.
+#define ACCEL_DEFAULT_RATE "12.5"
+#define ACCEL_DEFAULT_RANGE 16
+
+// Shake detection. Gravity and slow tilting are removed with a high-pass
+// filter, and the rest is averaged over a short window. A shake starts when
+// that average reaches SHAKE_ON_COUNTS and ends when it drops below
+// SHAKE_OFF_COUNTS, so it does not flicker around a single threshold.
+#define SHAKE_CUTOFF_HZ 1.0f        // High-pass cutoff
+#define SHAKE_WINDOW_S 0.25f        // Time constant of the average
+#define SHAKE_ON_COUNTS 250         // About 1 g of movement
+#define SHAKE_OFF_COUNTS 150
+
+// Function to open and initialize the accelerometer at the given rate and
+// range, returns file descriptor
+int open_accel(const char *rate, int range);
 
 // Function to close the accelerometer driver, accepts file descriptor
 int close_accel(int fd);
 
-// Function to read the acceleration data and return the magnitude
-int read_accel(int fd);
+// Function to start a thread that waits on the accelerometer with poll() and
+// feeds every new sample to the shake detector, returns -1 on failure
+int accel_start(int fd);
+
+// Function to check for shaking, runs over every sample the background
+// reader has seen. Returns 1 if the board is being shaken or was shaken since
+// the last call, 0 if not, and -1 if the reader is not running.
+int accel_shaken(void);
+
+// Function to stop the background reader
+void accel_stop(void);
 
 #endif // ACCEL_READ_H
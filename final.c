@@ -1,4 +1,5 @@
 // Corrected part6.c with issues fixed
+#define _GNU_SOURCE // Needed for clock_nanosleep
 #include <stdio.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -6,11 +7,16 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <time.h>
+#include <signal.h>
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include "accelRead.h" 
 #include "music.h"
+#include "videoBatch.h"
+#include "frameStats.h"
+#include "inputLog.h"
+#include "keyInput.h"
 
 // Constants
 #define TOP_CUTOFF 60
@@ -21,6 +27,13 @@
 #define KEY_BASE 0xFF200050  // Offset for the KEY input
 #define SW_BASE  0xFF200040  // Offset for the SW input
 
+// Timing constants. The simulation advances in fixed steps of game_speed
+// microseconds, while frames are drawn at the VGA refresh rate and show the
+// state interpolated between the last two steps.
+#define NSEC_PER_SEC 1000000000LL
+#define RENDER_PERIOD_NS (NSEC_PER_SEC / 60)
+#define MAX_FRAME_LAG_NS (NSEC_PER_SEC / 4)   // Drop simulation time beyond this after a stall
+
 // Ground constants
 #define GRASS_WIDTH 56
 #define GROUND_HEIGHT 19          // Ground height is now 19 pixels
@@ -60,6 +73,11 @@
 #define POND_Y GROUND_Y-1               // Position the lava at ground level
 #define INVINCIBILITY_DURATION 120 // 3 seconds at 60 FPS (assuming 60 FPS)
 
+// Headless autopilot constants
+#define SCRIPT_JUMP_DISTANCE 24    // Gap to a cat or mushroom at which the autopilot jumps
+#define SCRIPT_CROUCH_DISTANCE 8   // Gap to a crystal at which it starts to duck
+#define SCRIPT_SHAKE_STEPS 10      // Steps it stays in a pond before shaking
+
 // Score display constants
 #define SCORE_X 250            // Adjusted X position for score display
 #define SCORE_Y 0              // Y position for score display
@@ -78,6 +96,7 @@ typedef enum {
 typedef struct {
     int x;          // x position
     float y;        // y position (float for smoother movement)
+    float prev_y;   // y position at the previous simulation step
     int width, height; // Dimensions
     float dy;          // Vertical velocity (float)
     int is_jumping;
@@ -95,6 +114,7 @@ typedef struct {
 // Obstacle structure
 typedef struct {
     int x, y;          // Position (top-left corner)
+    int prev_x;        // x position at the previous simulation step
     int width, height; // Dimensions
     ObstacleType type; // Type of obstacle
     int active;
@@ -111,42 +131,141 @@ int game_over = 0;
 int game_speed = 20000; // Decreased sleep duration for faster gameplay (microseconds)
 unsigned int last_obstacle_time = 0;
 unsigned int obstacle_interval = 100; // Generate obstacle every 100 frames
+unsigned int prev_keys = 0x0;         // Keys seen at the previous step, for edge detection
+unsigned int game_seed;               // Seed for obstacle generation
 // Dynamic game speed variables
 unsigned int next_speed_increase = 1000; // Next score threshold for speed boost
 const int speed_decrement = 500;          // Amount to decrease game_speed each boost
 const unsigned int speed_interval = 1000; // Score interval for speed increase
 const unsigned int min_game_speed = 5000; // Minimum allowable game_speed (in microseconds)
 
+// Headless mode runs the game logic only, with inputs from the autopilot
+int headless = 0;
+
+// Inputs can be recorded to a log and replayed from one instead of read live
+int recording = 0;
+int replaying = 0;
+
 // Function prototypes
 int setup_mmap();
 void initialize_game();
+int run_headless(long long steps);
+unsigned int poll_keys();
+int poll_accel();
+unsigned int script_keys();
+int script_accel();
 void read_key_inputs();
+void step_game();
 void update_game_state();
-void draw_frame(int video_FD);
-void draw_ground(int video_FD);
-void draw_player(int video_FD);
-void draw_obstacles(int video_FD);
+void draw_frame(int video_FD, float alpha);
+void draw_ground(VideoBatch *batch);
+void draw_player(VideoBatch *batch, float alpha);
+void draw_obstacles(VideoBatch *batch, float alpha);
 void generate_obstacle();
 void move_obstacles();
 void check_collisions();
 int check_collision(Player *player, Obstacle *obstacle);
 int check_collision_with_lava();
-void display_score(int video_FD);
-void display_game_over(int video_FD);
+void display_score(VideoBatch *batch);
+void display_game_over(VideoBatch *batch);
 void cleanup(int video_FD);
 
 // Aceloremeter driver file ID
 int accel_FD;
 
-int main() {
-    int video_FD;
-    accel_FD = open_accel(); // Acceloremeter driver file ID
-    char command[64];
+// Display list for the current frame, submitted to the driver in one write
+VideoBatch frame_batch;
+
+// Set from signal handlers, checked once per frame by the game loop
+static volatile sig_atomic_t dump_stats_requested = 0;  // SIGUSR1: print frame time stats
+static volatile sig_atomic_t quit_requested = 0;        // SIGINT/SIGTERM: stop the game
+
+static void handle_signal(int sig) {
+    if (sig == SIGUSR1) {
+        dump_stats_requested = 1;
+    } else {
+        quit_requested = 1;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int video_FD, opt;
+    long long previous_time, current_time, accumulator = 0, step_ns, next_frame, frame_start, t;
+    long long headless_steps = 0;
+    struct timespec deadline;
+
+    // Options: -H <steps> to run headless, -s <seed> for a fixed obstacle sequence,
+    // -w <file> to record the inputs and -r <file> to replay them,
+    // -a <Hz> and -g <range> for the accelerometer's sample rate and range
+    const char *record_path = NULL, *replay_path = NULL;
+    const char *accel_rate = ACCEL_DEFAULT_RATE;
+    int accel_range = ACCEL_DEFAULT_RANGE;
+    game_seed = time(NULL);
+    while ((opt = getopt(argc, argv, "H:s:w:r:a:g:")) != -1) {
+        switch (opt) {
+        case 'H':
+            headless = 1;
+            headless_steps = atoll(optarg);
+            break;
+        case 's':
+            game_seed = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            record_path = optarg;
+            break;
+        case 'r':
+            replay_path = optarg;
+            break;
+        case 'a':
+            accel_rate = optarg;
+            break;
+        case 'g':
+            accel_range = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-H steps] [-s seed] [-w record_file | -r replay_file]"
+                    " [-a accel_rate] [-g accel_range]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    // A replay takes its seed from the recording
+    if (replay_path) {
+        if (log_open_read(replay_path, &game_seed) == -1) {
+            return -1;
+        }
+        replaying = 1;
+    } else if (record_path) {
+        if (log_open_write(record_path, game_seed) == -1) {
+            return -1;
+        }
+        recording = 1;
+    }
+
+    signal(SIGUSR1, handle_signal);
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    if (headless) {
+        return run_headless(headless_steps);
+    }
+
+    accel_FD = open_accel(accel_rate, accel_range); // Acceloremeter driver file ID
+
+    // Read the accelerometer in the background so the game loop never waits on it
+    if (!replaying) {
+        accel_start(accel_FD);
+    }
 
     if (setup_mmap() == -1) {
         return -1; // Fail if memory mapping didn't work
     }
 
+    // Sample the keys in the background so presses between steps are not missed
+    if (!replaying && key_input_start(key_ptr) == -1) {
+        return -1;
+    }
+
     // Open the video device driver
     if ((video_FD = open("/dev/video", O_RDWR)) == -1) {
         printf("Error opening /dev/video: %s\n", strerror(errno));
@@ -155,47 +274,76 @@ int main() {
 
     // Initialize game
     initialize_game();
-    // Draw the top background in the first buffer
-    snprintf(command, sizeof(command), "TopBackground");
-    write(video_FD, command, strlen(command));
 
-    // Swap buffers
-    snprintf(command, sizeof(command), "sync");
-    write(video_FD, command, strlen(command));
-
-    // Draw the top background in the second buffer
-    snprintf(command, sizeof(command), "TopBackground");
-    write(video_FD, command, strlen(command));
+    // Begin playing music
+    setup_audio();
+    play_game_music();
 
-    // Swap buffers back to the initial buffer
-    snprintf(command, sizeof(command), "sync");
-    write(video_FD, command, strlen(command));
+    batch_begin(&frame_batch);
+    // Compose the static background (sky, field and grass) once and let the
+    // driver keep it, every frame then only restores what the sprites covered
+    batch_top_background(&frame_batch);
+    batch_clear(&frame_batch);
+    draw_ground(&frame_batch);
+    batch_save_background(&frame_batch);
+    batch_submit(&frame_batch, video_FD);
     // Animation loop
-    while (1) {
-        
-        
-        read_key_inputs();
-        update_game_state();
-
-        draw_frame(video_FD);
-
+    previous_time = stats_now();
+    next_frame = previous_time;
+    frame_start = previous_time;
+    while (!quit_requested) {
+        // Run as many fixed simulation steps as real time has covered
+        current_time = stats_now();
+        accumulator += current_time - previous_time;
+        previous_time = current_time;
+        if (accumulator > MAX_FRAME_LAG_NS) {
+            accumulator = MAX_FRAME_LAG_NS;
+        }
 
+        step_ns = game_speed * 1000LL;
+        while (accumulator >= step_ns && !game_over) {
+            step_game();
+            accumulator -= step_ns;
+            step_ns = game_speed * 1000LL; // The step may have changed the speed
+        }
 
-        usleep(game_speed); // Control speed
+        // Keep the music's tempo in step with the game's speed
+        set_music_tempo(100 * 20000 / game_speed);
 
-        frame_count++;
+        // Draw the state part way between the last two steps
+        draw_frame(video_FD, (float)accumulator / step_ns);
 
         if (game_over) {
-            // Game over, display message and exit after a delay
-            stop_game_music();
+            // Game over, switch to the game over tune and display message, then exit after a delay
             play_game_over();
-            display_game_over(video_FD);
+            display_game_over(&frame_batch);
+            batch_sync(&frame_batch);
+            batch_submit(&frame_batch, video_FD);
             sleep(1);
             break;
         }
+
+        if (dump_stats_requested) {
+            dump_stats_requested = 0;
+            stats_dump(stderr);
+        }
+
+        // Sleep until the next frame is due, without letting lateness pile up
+        t = stats_now();
+        next_frame += RENDER_PERIOD_NS;
+        if (next_frame < t) {
+            next_frame = t;
+        }
+        deadline.tv_sec = next_frame / NSEC_PER_SEC;
+        deadline.tv_nsec = next_frame % NSEC_PER_SEC;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        t = stats_lap(STAGE_SLEEP, t);
+        stats_record(STAGE_FRAME, t - frame_start);
+        frame_start = t;
     }
 
     cleanup(video_FD);
+    log_close();
     return 0;
 }
 
@@ -230,6 +378,7 @@ void initialize_game() {
     player.width = PLAYER_WIDTH;
     player.height = PLAYER_HEIGHT;
     player.y = GROUND_Y - player.height; // Player's top Y position when standing
+    player.prev_y = player.y;
     player.dy = 0.0f;
     player.pond_counter = 0;
     player.is_jumping = 0;
@@ -247,20 +396,138 @@ void initialize_game() {
 
     frame_count = 0;
     game_over = 0;
+    game_speed = 20000;
+    last_obstacle_time = 0;
+    next_speed_increase = speed_interval;
+    prev_keys = 0x0;
 
-    // Begin playing music
-    setup_audio();
-    play_game_music();
+    srand(game_seed); // Seed random number generator
+}
 
-    srand(time(NULL)); // Seed random number generator
+// Function to run the game logic as fast as possible for the given number of
+// steps (or until a replay ends if steps is 0), starting a new game after each
+// game over, and report the step rate
+int run_headless(long long steps) {
+    long long i, start, elapsed;
+    unsigned long long total_score = 0;
+    unsigned int games = 0, best_score = 0;
+
+    initialize_game();
+    start = stats_now();
+    for (i = 0; i < steps || (steps == 0 && replaying); i++) {
+        step_game();
+        if (quit_requested) {
+            break;  // Interrupted, or the replay ran out during this step
+        }
+        if (game_over) {
+            games++;
+            total_score += frame_count;
+            if (frame_count > best_score) {
+                best_score = frame_count;
+            }
+            game_seed++; // Keep the run reproducible but vary the games
+            initialize_game();
+        }
+    }
+    elapsed = stats_now() - start;
+
+    printf("%lld steps in %.3f s, %.0f steps/s\n", i, elapsed / 1e9, i * 1e9 / elapsed);
+    printf("%u games over, mean score %.0f, best score %u\n", games,
+           games ? (double)total_score / games : 0.0, best_score);
+    stats_dump(stderr);
+    log_close();
+    return 0;
 }
 
+// Function to stop the game when the replay runs out or stops matching the game
+static void end_replay(const char *what) {
+    if (!quit_requested) {
+        fprintf(stderr, "Replay %s at step %u\n", what, frame_count);
+    }
+    quit_requested = 1;
+}
+
+// Function to get the KEY register value for this step
+unsigned int poll_keys() {
+    unsigned int keys = 0;
+    if (replaying) {
+        if (log_read_keys(&keys) == -1) {
+            end_replay("finished");
+        }
+    } else if (headless) {
+        keys = script_keys();
+    } else {
+        keys = key_input_read();
+    }
+    if (recording) {
+        log_keys(keys);
+    }
+    return keys;
+}
+
+// Function to check whether the board has been shaken, 1 if so, 0 if not and
+// -1 if there is no accelerometer
+int poll_accel() {
+    int value = -1;
+    if (replaying) {
+        if (log_read_accel(&value) == -1) {
+            end_replay("diverged");
+        }
+    } else if (headless) {
+        value = script_accel();
+    } else {
+        value = accel_shaken();
+    }
+    if (recording) {
+        log_accel(value);
+    }
+    return value;
+}
+
+// Function to find the closest active obstacle still ahead of the player
+static Obstacle *next_obstacle() {
+    Obstacle *next = NULL;
+    int i;
+    for (i = 0; i < MAX_OBSTACLES; i++) {
+        if (obstacles[i].active && obstacles[i].x + obstacles[i].width > player.x &&
+            (next == NULL || obstacles[i].x < next->x)) {
+            next = &obstacles[i];
+        }
+    }
+    return next;
+}
+
+// Function to generate the autopilot's KEY register value. A pressed key
+// reads as 1, and a jump starts when KEY1 is let go, so KEY1 is pressed for
+// one step at a time.
+unsigned int script_keys() {
+    static int jump_held = 0;
+    unsigned int keys = 0;
+    Obstacle *next = next_obstacle();
+    int gap = next ? next->x - (player.x + player.width) : SCREEN_WIDTH;
+
+    if (jump_held) {
+        jump_held = 0;
+    } else if (next && (next->type == CAT || next->type == MUSHROOM) &&
+               gap < SCRIPT_JUMP_DISTANCE && !player.is_jumping) {
+        keys |= 0x2;
+        jump_held = 1;
+    }
+    if (next && next->type == CRYSTAL && gap < SCRIPT_CROUCH_DISTANCE) {
+        keys |= 0x4;
+    }
+    return keys;
+}
+
+// Function to generate the autopilot's shake input, shaking once it has been
+// in a pond for a while
+int script_accel() {
+    return player.pond_counter >= SCRIPT_SHAKE_STEPS;
+}
 
-void read_key_inputs() {
-    static unsigned int prev_keys = 0x0;
-    if (!key_ptr) return;
 
-    unsigned int key_value = *key_ptr & 0xF;
+void read_key_inputs() {
+    unsigned int key_value = poll_keys();
     unsigned int keys = ~key_value & 0xF; // Active low keys
 
     // Edge detection
@@ -277,14 +544,17 @@ void read_key_inputs() {
     if (key1_edge && !player.is_jumping && !player.in_lava) {
         player.dy = PLAYER_JUMP_VELOCITY;
         player.is_jumping = 1;
+        play_sfx(SFX_JUMP);
     }
 
     // Crouch while KEY2 is held down
     if (!key2_pressed) { // Corrected logic
         if (!player.is_crouching) {
             player.is_crouching = 1;
+            play_sfx(SFX_DUCK);
             int delta_height = PLAYER_HEIGHT - PLAYER_CROUCH_HEIGHT;
             player.y += delta_height; // Adjust y to keep bottom position constant
+            player.prev_y += delta_height;
             player.height = PLAYER_CROUCH_HEIGHT;
         }
         if (player.is_jumping) {
@@ -296,6 +566,7 @@ void read_key_inputs() {
             player.is_crouching = 0;
             int delta_height = PLAYER_CROUCH_HEIGHT - PLAYER_HEIGHT;
             player.y += delta_height; // Adjust y to keep bottom position constant
+            player.prev_y += delta_height;
             player.height = PLAYER_HEIGHT;
         }
     }
@@ -306,10 +577,33 @@ void read_key_inputs() {
 
 
 
+// Function to advance the simulation by one fixed step
+void step_game() {
+    int i;
+
+    // Remember where everything was, for drawing between steps
+    player.prev_y = player.y;
+    for (i = 0; i < MAX_OBSTACLES; i++) {
+        obstacles[i].prev_x = obstacles[i].x;
+    }
+
+    long long t = stats_now();
+    read_key_inputs();
+    t = stats_lap(STAGE_INPUT, t);
+    update_game_state();
+    stats_lap(STAGE_UPDATE, t);
+    frame_count++;
+}
+
 // Function to update the game state
 void update_game_state() {
     if (game_over) return;
 
+    // Advance the running animation
+    if (!player.is_crouching && !player.is_jumping) {
+        player.run_frame = (player.run_frame + 1) % 16;
+    }
+
     // Update player position
     if (player.is_jumping) {
         player.dy += GRAVITY; // Apply gravity
@@ -342,7 +636,9 @@ void update_game_state() {
             if (game_speed < min_game_speed) {
                 game_speed = min_game_speed; // Enforce minimum game_speed
             }
-            printf("Game speed decreased to %u microseconds at frame %u\n", game_speed, frame_count);
+            if (!headless) {
+                printf("Game speed decreased to %u microseconds at frame %u\n", game_speed, frame_count);
+            }
         }
 
     
@@ -374,6 +670,7 @@ void generate_obstacle() {
         if (!obstacles[i].active) {
             // Initialize obstacle
             obstacles[i].x = SCREEN_WIDTH;
+            obstacles[i].prev_x = SCREEN_WIDTH;
             obstacles[i].active = 1;
 
             // Randomly select obstacle type
@@ -417,12 +714,13 @@ void check_collisions() {
                         game_speed = 100000; 
                         player.in_lava = 1;
                         player.pond_counter = 0;
+                        play_sfx(SFX_POND);
                     }
 
                     if (player.in_lava && !player.is_invincible) {
-                        int accelVal;
-                        accelVal = read_accel(accel_FD);
-                        if ( accelVal >= 500){
+                        int shaken;
+                        shaken = poll_accel();
+                        if (shaken > 0){
                             // Player escaped lava
                             player.in_lava = 0;
                             player.pond_counter = 0;
@@ -439,8 +737,8 @@ void check_collisions() {
                         else {
                             player.pond_counter++;
                         }
-                        if (accelVal != -1) {
-                            printf("Accel Value = %d\n", accelVal);
+                        if (shaken > 0 && !headless) {
+                            printf("Shake detected\n");
                         }
 
                     }
@@ -449,6 +747,7 @@ void check_collisions() {
                     // Collision with other obstacles results in immediate game over
                     if (!player.is_invincible) {
                         game_over = 1;
+                        play_sfx(SFX_COLLISION);
                     }
                  }
             }
@@ -510,49 +809,47 @@ int check_collision_with_lava() {
 }
 
 // Function to draw the entire frame
-void draw_frame(int video_FD) {
-    // Clear the screen
-    write(video_FD, "clear", 5);
+void draw_frame(int video_FD, float alpha) {
+    long long t = stats_now();
 
-    // Draw ground
-    draw_ground(video_FD);
+    // Restore the background under what was drawn into this buffer last time
+    batch_restore(&frame_batch);
 
     // Draw obstacles
-    draw_obstacles(video_FD);
+    draw_obstacles(&frame_batch, alpha);
 
     // Draw player
-    draw_player(video_FD);
+    draw_player(&frame_batch, alpha);
 
     // Display score
-    display_score(video_FD);
+    display_score(&frame_batch);
+    t = stats_lap(STAGE_BATCH, t);
 
     // If game over, display game over message
     if (game_over) {
-        display_game_over(video_FD);
+        display_game_over(&frame_batch);
+        batch_sync(&frame_batch);
     }
 
-    char command[64];
-    // Synchronize with VGA
-    snprintf(command, sizeof(command), "sync");
-    write(video_FD, command, strlen(command));
+    // Synchronize with VGA and send the whole frame in one write
+    batch_sync(&frame_batch);
+    batch_submit(&frame_batch, video_FD);
+    stats_lap(STAGE_SUBMIT, t);
 }
 
 // Function to draw the ground and moving texture lines
-void draw_ground(int video_FD) {
-    char command[64];
-    
-
+void draw_ground(VideoBatch *batch) {
     int grass_x;
     // Draw grass repeated grass obstacles for ground
     for (grass_x = 0; grass_x < SCREEN_WIDTH; grass_x += GRASS_WIDTH) {
-        snprintf(command, sizeof(command), "Grass %d,%d", grass_x, GROUND_Y);
-        write(video_FD, command, strlen(command));
+        batch_sprite(batch, SPRITE_GRASS, grass_x, GROUND_Y);
     }
 }
 
 // Function to draw the player
-void draw_player(int video_FD) {
-    int player_y_int = (int)(player.y + 0.5f); // Round to nearest integer
+void draw_player(VideoBatch *batch, float alpha) {
+    float y = player.prev_y + (player.y - player.prev_y) * alpha;
+    int player_y_int = (int)(y + 0.5f); // Round to nearest integer
 
     // If player is invincible, make them flash
     if (player.is_invincible) {
@@ -562,65 +859,51 @@ void draw_player(int video_FD) {
         }
     }
 
-    char command[64];
+    int sprite;
     if (player.is_crouching){
-        snprintf(command, sizeof(command), "DogCrouch %d,%d", player.x, player_y_int);
+        sprite = SPRITE_DOG_CROUCH;
     }
     else if (player.is_jumping){
-        snprintf(command, sizeof(command), "DogRun3 %d,%d", player.x, player_y_int);
+        sprite = SPRITE_DOGRUN3;
     }
     else if (player.run_frame < 5) {
-        snprintf(command, sizeof(command), "DogRun1 %d,%d", player.x, player_y_int);
-        player.run_frame++;
+        sprite = SPRITE_DOGRUN1;
     }
     else if (player.run_frame < 10) {
-        snprintf(command, sizeof(command), "DogRun2 %d,%d", player.x, player_y_int);
-        player.run_frame++;
-    }
-    else if (player.run_frame < 15) {
-        snprintf(command, sizeof(command), "DogRun3 %d,%d", player.x, player_y_int);
-        player.run_frame++;
+        sprite = SPRITE_DOGRUN2;
     }
     else {
-        snprintf(command, sizeof(command), "DogRun3 %d,%d", player.x, player_y_int);
-        player.run_frame = 0;
+        sprite = SPRITE_DOGRUN3;
     }
 
-    write(video_FD, command, strlen(command));
+    batch_sprite(batch, sprite, player.x, player_y_int);
 }
 
 
 // Function to draw the obstacles
-void draw_obstacles(int video_FD) {
-    char command[64];
-    int i;
+void draw_obstacles(VideoBatch *batch, float alpha) {
+    int i, x;
     for (i = 0; i < MAX_OBSTACLES; i++) {
         if (obstacles[i].active) {
+            x = obstacles[i].prev_x + (int)((obstacles[i].x - obstacles[i].prev_x) * alpha);
 
             // Draw obstacles
             switch(obstacles[i].type) {
                 // Draw cat obstacle
                 case CAT: 
-                     snprintf(command, sizeof(command), "Cat %d,%d",
-                     obstacles[i].x, obstacles[i].y);
-                     write(video_FD, command, strlen(command));
+                     batch_sprite(batch, SPRITE_CAT, x, obstacles[i].y);
                      break;
                 // Draw mushroom obstacle
                 case MUSHROOM: 
-                     snprintf(command, sizeof(command), "Mushroom %d,%d",
-                     obstacles[i].x, obstacles[i].y);
-                     write(video_FD, command, strlen(command));
+                     batch_sprite(batch, SPRITE_MUSHROOM, x, obstacles[i].y);
                      break;
                 // Draw crystal obstacle
                 case CRYSTAL: 
-                     snprintf(command, sizeof(command), "Crystal %d,%d", obstacles[i].x, obstacles[i].y);
-                     write(video_FD, command, strlen(command));
+                     batch_sprite(batch, SPRITE_CRYSTAL, x, obstacles[i].y);
                      break;
                 // Draw pond obstacle
                 case POND: 
-                     snprintf(command, sizeof(command), "Pond %d,%d",
-                     obstacles[i].x, obstacles[i].y);
-                     write(video_FD, command, strlen(command));
+                     batch_sprite(batch, SPRITE_POND, x, obstacles[i].y);
                      break;
                 default:
                     printf("Error Drawing obstacle\n");
@@ -632,44 +915,36 @@ void draw_obstacles(int video_FD) {
 
 
 // Function to display the score
-void display_score(int video_FD) {
-    char command[128];
+void display_score(VideoBatch *batch) {
     char text[64];
     snprintf(text, sizeof(text), "SScore: %u", frame_count);
 
     // Erase previous text by writing spaces over it
-    snprintf(command, sizeof(command), "text %d,%d                     ", SCORE_X, SCORE_Y);
-    write(video_FD, command, strlen(command));
+    batch_text(batch, SCORE_X, SCORE_Y, "                     ");
 
     // Write new score
-    snprintf(command, sizeof(command), "text %d,%d %s", SCORE_X, SCORE_Y, text);
-    write(video_FD, command, strlen(command));
+    batch_text(batch, SCORE_X, SCORE_Y, text);
 }
 
 // Function to display "Game Over" message
-void display_game_over(int video_FD) {
-
-
-    char command[128];
-    static int flash = 0;
-    flash = !flash;
-
-    //if (flash) {
-        // Display "Game Over" message
-        snprintf(command, sizeof(command), "text 100,100 Game Over");
-        write(video_FD, command, strlen(command));
-
-        snprintf(command, sizeof(command), "sync");
-        write(video_FD, command, strlen(command));
-   // } else {
-        // Erase "Game Over" message
-    //    snprintf(command, sizeof(command), "text 100,100           ");
-        //write(video_FD, command, strlen(command));
-   // }
+void display_game_over(VideoBatch *batch) {
+    // Display "Game Over" message
+    batch_text(batch, 100, 100, "Game Over");
 }
 
 // Function to clean up resources
 void cleanup(int video_FD) {
+    // Stop sampling the keys and the accelerometer
+    key_input_stop();
+    accel_stop();
+    close_accel(accel_FD);
+
+    // Let the game over tune finish and stop the audio thread
+    cleanup_audio();
+
+    // Report where the frame time went
+    stats_dump(stderr);
+
     // Close the video device
     close(video_FD);
 }
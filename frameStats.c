@@ -0,0 +1,120 @@
+/*Per-stage frame time histograms*/
+#define _POSIX_C_SOURCE 200809L // Needed for clock_gettime with -std=c99
+// Durations go into log-linear buckets in the style of HDR histograms: each
+// power of two is split into 16 equal sub-buckets, so any recorded value is
+// known to within about 6% at a fixed cost of one array increment.
+#include <string.h>
+#include <time.h>
+#include "frameStats.h"
+
+#define SUB_BUCKET_BITS 4
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define MAX_EXPONENT 40                           // Values up to 2^40 ns (about 18 minutes)
+#define NUM_BUCKETS ((MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS)
+
+typedef struct {
+    unsigned int buckets[NUM_BUCKETS];
+    unsigned long long count;
+    long long total;
+    long long max;
+} Histogram;
+
+static Histogram histograms[NUM_STAGES];
+
+static const char *stage_names[NUM_STAGES] = {
+    "input",
+    "update",
+    "batch",
+    "submit",
+    "sleep",
+    "frame"
+};
+
+// Function to find the bucket for a value
+static int bucket_index(long long value) {
+    int exponent = 0;
+
+    if (value < SUB_BUCKETS) {
+        return value < 0 ? 0 : (int)value;
+    }
+    // Shift the value down until it fits in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+    while ((value >> exponent) >= 2 * SUB_BUCKETS) {
+        exponent++;
+    }
+    if (exponent > MAX_EXPONENT - SUB_BUCKET_BITS) {
+        return NUM_BUCKETS - 1;
+    }
+    return (exponent + 1) * SUB_BUCKETS + (int)((value >> exponent) - SUB_BUCKETS);
+}
+
+// Function to get the smallest value that falls in a bucket
+static long long bucket_value(int index) {
+    int exponent = index / SUB_BUCKETS - 1;
+    if (exponent < 0) {
+        return index;
+    }
+    return (long long)(SUB_BUCKETS + index % SUB_BUCKETS) << exponent;
+}
+
+// Function to find the value below which a fraction of the samples fall
+static long long percentile(const Histogram *h, double fraction) {
+    unsigned long long target = (unsigned long long)(h->count * fraction);
+    unsigned long long seen = 0;
+    int i;
+
+    for (i = 0; i < NUM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen > target) {
+            return bucket_value(i);
+        }
+    }
+    return h->max;
+}
+
+long long stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void stats_record(Stage stage, long long ns) {
+    Histogram *h = &histograms[stage];
+    h->buckets[bucket_index(ns)]++;
+    h->count++;
+    h->total += ns;
+    if (ns > h->max) {
+        h->max = ns;
+    }
+}
+
+long long stats_lap(Stage stage, long long start) {
+    long long now = stats_now();
+    stats_record(stage, now - start);
+    return now;
+}
+
+void stats_dump(FILE *out) {
+    int i;
+    const Histogram *h;
+
+    fprintf(out, "%-16s %10s %10s %10s %10s %10s\n",
+            "stage", "count", "p50_us", "p99_us", "max_us", "mean_us");
+    for (i = 0; i < NUM_STAGES; i++) {
+        h = &histograms[i];
+        if (h->count == 0) {
+            continue;
+        }
+        fprintf(out, "%-16s %10llu %10.1f %10.1f %10.1f %10.1f\n", stage_names[i], h->count,
+                percentile(h, 0.50) / 1000.0, percentile(h, 0.99) / 1000.0,
+                h->max / 1000.0, (double)h->total / h->count / 1000.0);
+    }
+    if (histograms[STAGE_SUBMIT].count) {
+        fprintf(out, "(drawing happens in the driver during submit, see "
+                     "/sys/kernel/debug/video/stats for the cost of each command)\n");
+    }
+    fflush(out);
+}
+
+void stats_reset(void) {
+    memset(histograms, 0, sizeof(histograms));
+}
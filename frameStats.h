@@ -0,0 +1,33 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <stdio.h>
+
+// Stages of the game loop that are timed
+typedef enum {
+    STAGE_INPUT,            // read_key_inputs
+    STAGE_UPDATE,           // update_game_state
+    STAGE_BATCH,            // building the frame's command batch (encoding only)
+    STAGE_SUBMIT,           // write of the batch: the driver draws it and syncs
+    STAGE_SLEEP,            // waiting for the next frame
+    STAGE_FRAME,            // whole frame, start to start
+    NUM_STAGES
+} Stage;
+
+// Function to read the monotonic clock in nanoseconds
+long long stats_now(void);
+
+// Function to add one duration in nanoseconds to a stage's histogram
+void stats_record(Stage stage, long long ns);
+
+// Function to record the time since start against a stage, returns the current time
+// so consecutive stages can be chained: t = stats_lap(STAGE_A, t);
+long long stats_lap(Stage stage, long long start);
+
+// Function to print count, p50, p99, max and mean of every stage
+void stats_dump(FILE *out);
+
+// Function to clear all histograms
+void stats_reset(void);
+
+#endif // FRAME_STATS_H
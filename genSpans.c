@@ -0,0 +1,62 @@
+/*Offline generator for the opaque span tables in spriteSpans.h*/
+// Usage: ./genSpans > spriteSpans.h
+#include <stdio.h>
+#include "pixelArrays.h"
+
+#define TRANSPARENT_COLOR 0x2D9D
+
+// Function to print the span table of one sprite
+static void print_spans(const char *name, const unsigned short *data, int width, int height) {
+    int i, j, start, count = 0;
+
+    // Index of the first span of each row, plus one past the last row
+    printf("static const unsigned short %s_rows[%d] = {", name, height + 1);
+    for (i = 0; i < height; i++) {
+        printf("%s%d", (i == 0) ? "\n    " : (i % 16) ? ", " : ",\n    ", count);
+        for (j = 0; j < width; j++) {
+            if (data[i * width + j] != TRANSPARENT_COLOR &&
+                (j == 0 || data[i * width + j - 1] == TRANSPARENT_COLOR)) {
+                count++;
+            }
+        }
+    }
+    printf(", %d\n};\n", count);
+
+    printf("static const struct sprite_span %s_spans[%d] = {", name, count > 0 ? count : 1);
+    count = 0;
+    for (i = 0; i < height; i++) {
+        for (j = 0; j < width; j++) {
+            if (data[i * width + j] == TRANSPARENT_COLOR) {
+                continue;
+            }
+            start = j;
+            while (j < width && data[i * width + j] != TRANSPARENT_COLOR) {
+                j++;
+            }
+            printf("%s{%d, %d}", (count == 0) ? "\n    " : (count % 8) ? ", " : ",\n    ",
+                   start, j - start);
+            count++;
+        }
+    }
+    printf("\n};\n\n");
+}
+
+int main(void) {
+    printf("// spriteSpans.h\n");
+    printf("// Generated by genSpans from pixelArrays.h, do not edit by hand.\n");
+    printf("// Each row of a sprite is a list of opaque runs (x offset, length) so the\n");
+    printf("// blitter can copy whole runs and skip transparent (0x%04X) pixels.\n", TRANSPARENT_COLOR);
+    printf("#ifndef SPRITE_SPANS_H\n#define SPRITE_SPANS_H\n\n");
+    printf("struct sprite_span {\n    unsigned short x, len;\n};\n\n");
+
+    print_spans("DogRun1", &DogRun1[0][0], DOGRUN_WIDTH, DOGRUN_HEIGHT);
+    print_spans("DogRun2", &DogRun2[0][0], DOGRUN_WIDTH, DOGRUN_HEIGHT);
+    print_spans("DogRun3", &DogRun3[0][0], DOGRUN_WIDTH, DOGRUN_HEIGHT);
+    print_spans("Dog_Crouch", &Dog_Crouch[0][0], DOG_CROUCH_WIDTH, DOG_CROUCH_HEIGHT);
+    print_spans("Cat", &Cat[0][0], CAT_WIDTH, CAT_HEIGHT);
+    print_spans("Mushroom", &Mushroom[0][0], MUSHROOM_WIDTH, MUSHROOM_HEIGHT);
+    print_spans("Crystal", &Crystal[0][0], CRYSTAL_WIDTH, CRYSTAL_HEIGHT);
+
+    printf("#endif // SPRITE_SPANS_H\n");
+    return 0;
+}
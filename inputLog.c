@@ -0,0 +1,92 @@
+/*Recording and replay of the game's inputs*/
+#include <stdio.h>
+#include <string.h>
+#include "inputLog.h"
+
+#define LOG_BUFFER_BYTES 65536
+
+static FILE *log_file = NULL;
+static char log_buffer[LOG_BUFFER_BYTES];
+
+// Function to write a 32-bit value in little endian order
+static void put_u32(unsigned int value) {
+    unsigned char bytes[4] = { value, value >> 8, value >> 16, value >> 24 };
+    fwrite(bytes, 1, 4, log_file);
+}
+
+// Function to read a 32-bit little endian value, returns -1 at the end of the file
+static int get_u32(unsigned int *value) {
+    unsigned char bytes[4];
+    if (fread(bytes, 1, 4, log_file) != 4) {
+        return -1;
+    }
+    *value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+    return 0;
+}
+
+int log_open_write(const char *path, unsigned int seed) {
+    log_file = fopen(path, "wb");
+    if (log_file == NULL) {
+        perror("Failed to open input log for writing");
+        return -1;
+    }
+    setvbuf(log_file, log_buffer, _IOFBF, sizeof(log_buffer));
+    fwrite("DRUN", 1, 4, log_file);
+    put_u32(INPUT_LOG_VERSION);
+    put_u32(seed);
+    return 0;
+}
+
+int log_open_read(const char *path, unsigned int *seed) {
+    char magic[4];
+    unsigned int version;
+
+    log_file = fopen(path, "rb");
+    if (log_file == NULL) {
+        perror("Failed to open input log");
+        return -1;
+    }
+    setvbuf(log_file, log_buffer, _IOFBF, sizeof(log_buffer));
+    if (fread(magic, 1, 4, log_file) != 4 || memcmp(magic, "DRUN", 4) != 0 ||
+        get_u32(&version) < 0 || version != INPUT_LOG_VERSION || get_u32(seed) < 0) {
+        fprintf(stderr, "%s is not an input log this version can replay\n", path);
+        fclose(log_file);
+        log_file = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void log_keys(unsigned int keys) {
+    fputc(keys & 0xF, log_file);
+}
+
+void log_accel(int value) {
+    fputc(INPUT_LOG_ACCEL, log_file);
+    put_u32(value);
+}
+
+int log_read_keys(unsigned int *keys) {
+    int c = fgetc(log_file);
+    if (c == EOF || c & INPUT_LOG_ACCEL) {
+        return -1;
+    }
+    *keys = c;
+    return 0;
+}
+
+int log_read_accel(int *value) {
+    unsigned int raw;
+    if (fgetc(log_file) != INPUT_LOG_ACCEL || get_u32(&raw) < 0) {
+        return -1;
+    }
+    *value = (int)raw;
+    return 0;
+}
+
+void log_close(void) {
+    if (log_file) {
+        fclose(log_file);
+        log_file = NULL;
+    }
+}
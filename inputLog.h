@@ -0,0 +1,35 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+// Recording of everything that feeds the game logic, so a run can be
+// replayed exactly, on the board or headless.
+//
+// File layout, little endian:
+//   header:  "DRUN", uint32 version, uint32 seed
+//   records: one byte per simulation step holding the KEY register value
+//            (bits 0-3), or INPUT_LOG_ACCEL followed by an int32 for each
+//            shake check the game made during that step (poll_accel())
+
+#define INPUT_LOG_VERSION 2
+#define INPUT_LOG_ACCEL 0x10
+
+// Function to start recording to path, returns -1 on failure
+int log_open_write(const char *path, unsigned int seed);
+
+// Function to open a recording for replay and get its seed, returns -1 on failure
+int log_open_read(const char *path, unsigned int *seed);
+
+// Functions to record one step's keys and one accelerometer reading
+void log_keys(unsigned int keys);
+void log_accel(int value);
+
+// Functions to replay the next step's keys and the next accelerometer reading.
+// Return -1 at the end of the recording or when the game asks for something
+// other than what was recorded next, i.e. the replay has diverged.
+int log_read_keys(unsigned int *keys);
+int log_read_accel(int *value);
+
+// Function to flush and close the recording
+void log_close(void);
+
+#endif // INPUT_LOG_H
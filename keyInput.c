@@ -0,0 +1,85 @@
+/*Pushbutton sampling thread with a lock-free handoff to the game loop*/
+#define _GNU_SOURCE // Needed for clock_nanosleep
+#include <stdio.h>
+#include <time.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "keyInput.h"
+
+// The sampler publishes both fields of this word and the game loop clears
+// the latched presses when it reads them:
+//   bits 0-3  debounced KEY state
+//   bits 4-7  keys pressed since the last key_input_read()
+static _Atomic unsigned int key_word = 0;
+static atomic_bool sampling = false;
+
+static volatile unsigned int *key_register;
+static pthread_t key_thread;
+
+// Function to sample, debounce and publish the keys until sampling is cleared
+static void *key_sampler_thread(void *arg) {
+    struct timespec next;
+    unsigned int raw, state = 0, pressed, old, new;
+    int stable[4] = { 0 };
+    int i;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (atomic_load_explicit(&sampling, memory_order_relaxed)) {
+        // A key changes state once it has read differently for enough samples in a row
+        raw = *key_register & 0xF;
+        pressed = 0;
+        for (i = 0; i < 4; i++) {
+            if (((raw ^ state) >> i) & 1) {
+                if (++stable[i] >= KEY_DEBOUNCE_SAMPLES) {
+                    state ^= 1u << i;
+                    pressed |= (state >> i & 1) << i;
+                    stable[i] = 0;
+                }
+            } else {
+                stable[i] = 0;
+            }
+        }
+
+        // Publish the state, adding any new presses to the ones not yet read
+        old = atomic_load_explicit(&key_word, memory_order_relaxed);
+        do {
+            new = (old & 0xF0) | (pressed << 4) | state;
+        } while (old != new &&
+                 !atomic_compare_exchange_weak_explicit(&key_word, &old, new,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+
+        next.tv_nsec += KEY_SAMPLE_PERIOD_NS;
+        if (next.tv_nsec >= 1000000000) {
+            next.tv_nsec -= 1000000000;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+int key_input_start(volatile unsigned int *key_ptr) {
+    key_register = key_ptr;
+    atomic_store(&key_word, *key_ptr & 0xF);
+    atomic_store(&sampling, true);
+    if (pthread_create(&key_thread, NULL, key_sampler_thread, NULL) != 0) {
+        perror("Failed to start key sampling thread");
+        atomic_store(&sampling, false);
+        return -1;
+    }
+    return 0;
+}
+
+unsigned int key_input_read(void) {
+    // Take the latched presses and leave the current state in place
+    unsigned int word = atomic_fetch_and_explicit(&key_word, 0xF, memory_order_acquire);
+    return (word & 0xF) | (word >> 4);
+}
+
+void key_input_stop(void) {
+    if (atomic_exchange(&sampling, false)) {
+        pthread_join(key_thread, NULL);
+    }
+}
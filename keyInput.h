@@ -0,0 +1,23 @@
+#ifndef KEY_INPUT_H
+#define KEY_INPUT_H
+
+// Background sampling of the KEY pushbuttons. A thread reads the KEY register
+// every KEY_SAMPLE_PERIOD_NS, debounces it and hands the result to the game
+// loop through a single atomic word, so the loop never waits on it.
+// A key pressed at any time since the last key_input_read() is reported as
+// pressed once, even if it has been let go again, so short taps between two
+// simulation steps are not lost.
+
+#define KEY_SAMPLE_PERIOD_NS 1000000   // 1 kHz
+#define KEY_DEBOUNCE_SAMPLES 3         // Samples a key must hold still to change state
+
+// Function to start sampling the KEY register at key_ptr, returns -1 on failure
+int key_input_start(volatile unsigned int *key_ptr);
+
+// Function to get the KEY register value for this step (pressed keys read as 1)
+unsigned int key_input_read(void);
+
+// Function to stop the sampling thread
+void key_input_stop(void);
+
+#endif // KEY_INPUT_H
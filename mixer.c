@@ -0,0 +1,203 @@
+/*Multi-voice audio mixer for the music and sound effects*/
+#include <string.h>
+#include "mixer.h"
+
+// Envelope levels are Q24, so slow releases still move by a whole step per sample
+#define ENV_BITS 24
+#define ENV_FULL (1 << ENV_BITS)
+
+typedef enum {
+    ENV_IDLE,
+    ENV_ATTACK,
+    ENV_HOLD,
+    ENV_RELEASE
+} EnvStage;
+
+typedef struct {
+    Oscillator osc;
+    int32_t sweep;              // Added to the phase increment every sample
+    int32_t gain;
+    int32_t fade, fade_target, fade_step;
+    EnvStage stage;
+    int32_t level;
+    int32_t attack_step, release_step;
+    int hold;                   // Samples left at full level
+} Voice;
+
+// Effect sounds, indexed by Sfx
+static const Sound sfx_sounds[NUM_SFX] = {
+    [SFX_JUMP]      = { WAVE_SQUARE,   300.0f, 900.0f, 0x3000, 2,  60,  60 },
+    [SFX_DUCK]      = { WAVE_TRIANGLE, 400.0f, 150.0f, 0x4000, 2,  30,  50 },
+    [SFX_POND]      = { WAVE_SAW,      600.0f,  80.0f, 0x3000, 5, 100, 250 },
+    [SFX_COLLISION] = { WAVE_SQUARE,   200.0f,  40.0f, 0x5000, 1, 150, 400 },
+};
+
+static Voice voices[MIXER_VOICES];
+static int mixer_rate;
+
+// Function to convert a length in ms to samples, at least one
+static int ms_to_samples(int ms) {
+    int samples = ms * mixer_rate / 1000;
+    return (samples > 0) ? samples : 1;
+}
+
+void mixer_init(int sample_rate) {
+    int i;
+
+    mixer_rate = sample_rate;
+    memset(voices, 0, sizeof(voices));
+    for (i = 0; i < MIXER_VOICES; i++) {
+        voices[i].fade = voices[i].fade_target = MIXER_GAIN_FULL;
+    }
+}
+
+// Function to start a voice, with the envelope lengths in samples
+static void start_voice(Voice *v, const Sound *sound, int attack, int hold, int release) {
+    Oscillator end = v->osc;
+    int length = attack + hold + release;
+
+    osc_set(&v->osc, sound->wave, sound->start_hz, mixer_rate);
+    osc_set(&end, sound->wave, sound->end_hz, mixer_rate);
+    v->sweep = (int32_t)(((int64_t)end.increment - v->osc.increment) / length);
+    v->gain = sound->gain;
+
+    // Ramp up from wherever the voice is now rather than from silence
+    v->attack_step = (ENV_FULL - v->level) / attack;
+    if (v->attack_step < 1) {
+        v->attack_step = 1;
+    }
+    v->hold = hold;
+    v->release_step = ENV_FULL / release;
+    v->stage = ENV_ATTACK;
+}
+
+void mixer_play(int voice, const Sound *sound) {
+    start_voice(&voices[voice], sound, ms_to_samples(sound->attack_ms),
+                sound->hold_ms * mixer_rate / 1000, ms_to_samples(sound->release_ms));
+}
+
+void mixer_play_note(int voice, Waveform wave, float frequency, int gain, int samples) {
+    Sound note = { wave, frequency, frequency, gain, 0, 0, 0 };
+    int attack = ms_to_samples(MIXER_NOTE_ATTACK_MS);
+    int release = ms_to_samples(MIXER_NOTE_RELEASE_MS);
+    int hold = samples - attack - release;
+
+    // Notes too short for the whole envelope get a shorter release
+    if (hold < 0) {
+        hold = 0;
+        release = (samples > attack) ? samples - attack : 1;
+    }
+    start_voice(&voices[voice], &note, attack, hold, release);
+}
+
+void mixer_play_sfx(Sfx sfx) {
+    int best = MIXER_MUSIC_VOICES;
+    int i;
+
+    for (i = MIXER_MUSIC_VOICES; i < MIXER_VOICES; i++) {
+        if (voices[i].stage == ENV_IDLE) {
+            best = i;
+            break;
+        }
+        if (voices[i].level < voices[best].level) {
+            best = i;
+        }
+    }
+    mixer_play(best, &sfx_sounds[sfx]);
+}
+
+void mixer_release(int voice) {
+    if (voices[voice].stage != ENV_IDLE) {
+        voices[voice].stage = ENV_RELEASE;
+    }
+}
+
+void mixer_fade(int voice, int level, int ms) {
+    Voice *v = &voices[voice];
+
+    v->fade_target = level;
+    if (ms == 0) {
+        v->fade = level;
+        v->fade_step = 0;
+        return;
+    }
+    v->fade_step = (level - v->fade) / ms_to_samples(ms);
+    if (v->fade_step == 0) {
+        v->fade_step = (level > v->fade) ? 1 : -1;
+    }
+}
+
+// Function to add a voice's next samples to the mix
+static void render_voice(Voice *v, int32_t *mix, int samples) {
+    int32_t amp;
+    int i;
+
+    for (i = 0; i < samples; i++) {
+        switch (v->stage) {
+        case ENV_ATTACK:
+            v->level += v->attack_step;
+            if (v->level >= ENV_FULL) {
+                v->level = ENV_FULL;
+                v->stage = ENV_HOLD;
+            }
+            break;
+        case ENV_HOLD:
+            if (v->hold-- <= 0) {
+                v->stage = ENV_RELEASE;
+            }
+            break;
+        case ENV_RELEASE:
+            v->level -= v->release_step;
+            if (v->level <= 0) {
+                v->level = 0;
+                v->stage = ENV_IDLE;
+                return;
+            }
+            break;
+        case ENV_IDLE:
+            return;
+        }
+
+        if (v->fade_step) {
+            v->fade += v->fade_step;
+            if ((v->fade_step > 0) == (v->fade >= v->fade_target)) {
+                v->fade = v->fade_target;
+                v->fade_step = 0;
+            }
+        }
+
+        // Q15 level times Q15 gain and fade, then the oscillator: every product fits in 31 bits
+        amp = ((v->level >> (ENV_BITS - 15)) * v->gain) >> 15;
+        amp = (amp * v->fade) >> 15;
+        mix[i] += (osc_next(&v->osc) * amp) >> 15;
+        v->osc.increment += v->sweep;
+    }
+}
+
+void mixer_render(int16_t *out, int samples) {
+    int32_t mix[MIXER_MAX_BLOCK];
+    int block, i;
+
+    while (samples > 0) {
+        block = (samples < MIXER_MAX_BLOCK) ? samples : MIXER_MAX_BLOCK;
+        memset(mix, 0, block * sizeof(mix[0]));
+        for (i = 0; i < MIXER_VOICES; i++) {
+            if (voices[i].stage != ENV_IDLE) {
+                render_voice(&voices[i], mix, block);
+            }
+        }
+
+        // Saturate rather than wrap when the voices add up past full scale
+        for (i = 0; i < block; i++) {
+            if (mix[i] > 32767) {
+                out[i] = 32767;
+            } else if (mix[i] < -32768) {
+                out[i] = -32768;
+            } else {
+                out[i] = mix[i];
+            }
+        }
+        out += block;
+        samples -= block;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+#include "synth.h"
+
+// Real-time mixer for the audio thread. Each voice is an oscillator with a
+// gain, a fade level, a linear pitch sweep and an attack/hold/release
+// envelope. Voices are summed in 32 bits and the mix saturates to 16 bits, all
+// in fixed point, so a sample costs a few multiplies per active voice.
+//
+// The first MIXER_MUSIC_VOICES voices play the music, the others play sound
+// effects.
+// Only the audio thread calls these functions; the game loop reaches them
+// through the commands in music.c.
+
+#define MIXER_VOICES 6
+#define MIXER_MUSIC_VOICES 2
+#define MIXER_MAX_BLOCK 128         // Most samples rendered in one pass, the size of the output FIFO
+#define MIXER_GAIN_FULL 32767       // Voice gains and fade levels are Q15
+#define MIXER_NOTE_ATTACK_MS 2      // Envelope of music notes
+#define MIXER_NOTE_RELEASE_MS 10
+
+typedef enum {
+    SFX_JUMP,
+    SFX_DUCK,
+    SFX_POND,
+    SFX_COLLISION,
+    NUM_SFX
+} Sfx;
+
+// A sound for one voice: the pitch sweeps from start_hz to end_hz over its
+// whole length, attack + hold + release
+typedef struct {
+    Waveform wave;
+    float start_hz, end_hz;
+    int gain;
+    int attack_ms, hold_ms, release_ms;
+} Sound;
+
+// Function to silence every voice, before audio starts
+void mixer_init(int sample_rate);
+
+// Function to start a sound on a voice. A voice that is still playing keeps
+// its phase, level and fade, so a new note follows on without a click.
+void mixer_play(int voice, const Sound *sound);
+
+// Function to play a music note lasting exactly samples, its release included
+void mixer_play_note(int voice, Waveform wave, float frequency, int gain, int samples);
+
+// Function to start a sound effect on an idle voice, or else the quietest
+void mixer_play_sfx(Sfx sfx);
+
+// Function to let a voice's sound die away with its release
+void mixer_release(int voice);
+
+// Function to ramp a voice's fade level to level (Q15) over ms, 0 ms sets it
+void mixer_fade(int voice, int level, int ms);
+
+// Function to render the next samples (full scale +-32767)
+void mixer_render(int16_t *out, int samples);
+
+#endif // MIXER_H
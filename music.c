@@ -5,22 +5,56 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/mman.h>
-#include <math.h>
 #include <sched.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "synth.h"
+#include "mixer.h"
+#include "sequencer.h"
+#include "musicData.h"
+
+// Commands from the game loop to the audio thread
+typedef enum {
+    AUDIO_PLAY_TRACK,   // arg: TrackId
+    AUDIO_STOP,
+    AUDIO_FADE,         // arg: fade out time in ms, then stop
+    AUDIO_SFX,          // arg: Sfx
+    AUDIO_WAVEFORM,     // arg: Waveform for the melody
+    AUDIO_TEMPO,        // arg: playback speed in percent
+    AUDIO_QUIT          // Stop the thread once a tune that does not loop has ended
+} AudioCommandType;
+
+typedef struct {
+    AudioCommandType type;
+    int arg;
+} AudioCommand;
+
+typedef enum {
+    TRACK_GAME_MUSIC,
+    TRACK_GAME_OVER,
+    NUM_TRACKS
+} TrackId;
 
 // Global Variables
 volatile unsigned int *audio_base = NULL;
-static bool music_running = false;  // To control game music loop
-static pthread_t music_thread;
+static pthread_t audio_thread;
+static Sequencer tracks[NUM_TRACKS];   // Each track ready to play from the start
+static int music_tempo = 100;          // Last tempo sent to the audio thread
+
+// Command ring. Only the game loop moves ring_head and only the audio thread
+// moves ring_tail; each publishes its index with a release store, so neither
+// side ever waits for the other.
+static AudioCommand ring[AUDIO_RING_SIZE];
+static _Atomic unsigned int ring_head = 0;
+static _Atomic unsigned int ring_tail = 0;
 
 // Function Prototypes (static for internal use only)
-static void *game_music_thread(void *arg);
-static void *game_over_thread(void *arg);
-static void play_sine_wave(float frequency, int duration_ms);
+static void *audio_thread_main(void *arg);
+static void set_thread_cpu(pthread_t thread, int cpu_id);
 
-// Setup Audio 
+// Setup Audio and start the audio thread
 void setup_audio() {
     int fd = open("/dev/mem", O_RDWR | O_SYNC);
     if (fd < 0) {
@@ -28,7 +62,7 @@ void setup_audio() {
         exit(EXIT_FAILURE);
     }
 
-    // Memory map audio port physical address 
+    // Memory map audio port physical address
     unsigned int page_offset = AUDIO_BASE & (PAGE_SIZE - 1);
     void *virtual_base = mmap(NULL, AUDIO_SPAN + page_offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, AUDIO_BASE & ~(PAGE_SIZE - 1));
     if (virtual_base == MAP_FAILED) {
@@ -39,6 +73,20 @@ void setup_audio() {
 
     audio_base = (unsigned int *)((char *)virtual_base + page_offset);
     close(fd);
+
+    synth_init();
+    mixer_init(SAMPLING_RATE);
+    if (seq_open(&tracks[TRACK_GAME_MUSIC], game_music_seq, sizeof(game_music_seq), SAMPLING_RATE) < 0 ||
+        seq_open(&tracks[TRACK_GAME_OVER], game_over_seq, sizeof(game_over_seq), SAMPLING_RATE) < 0) {
+        fprintf(stderr, "Music data is not a valid sequence\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (pthread_create(&audio_thread, NULL, audio_thread_main, NULL) != 0) {
+        perror("Failed to start audio thread");
+        exit(EXIT_FAILURE);
+    }
+    set_thread_cpu(audio_thread, 1); // Assign to CPU core 1
 }
 
 // Clear FIFO
@@ -47,92 +95,169 @@ void clear_audio_fifo() {
     while (*(audio_base + AUDIO_CONTROL) & 0x10); // Wait for CW bit to clear
 }
 
-// Cleanup Audio
-void cleanup_audio() {
-    if (audio_base) {
-        munmap((void *)audio_base, AUDIO_SPAN);
+// Send a command to the audio thread, returns -1 if the ring is full
+static int send_command(AudioCommandType type, int arg) {
+    unsigned int head, tail;
+
+    if (audio_base == NULL) {
+        return -1; // No audio, e.g. running headless
+    }
+    head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+    if (head - tail == AUDIO_RING_SIZE) {
+        return -1;
     }
+    ring[head & (AUDIO_RING_SIZE - 1)].type = type;
+    ring[head & (AUDIO_RING_SIZE - 1)].arg = arg;
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+    return 0;
 }
 
-// Play a sine wave tone
-static void play_sine_wave(float frequency, int duration_ms) {
-    int samples = (SAMPLING_RATE * duration_ms) / 1000;
-    float phase_increment = 2 * PI * frequency / SAMPLING_RATE;
-    float phase = 0.0;
-
-    for (int i = 0; i < samples; i++) {
-        while (((*(audio_base + AUDIO_FIFOSPACE) >> 24) & 0xFF) == 0 || // Left FIFO
-               ((*(audio_base + AUDIO_FIFOSPACE) >> 16) & 0xFF) == 0);  // Right FIFO
+// Take the next command off the ring, returns 0 if there is none
+static int receive_command(AudioCommand *command) {
+    unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
 
-        int sample = (int)(sin(phase) * MAX_VOLUME);
-        *(audio_base + AUDIO_LEFTDATA) = sample;
-        *(audio_base + AUDIO_RIGHTDATA) = sample;
+    if (tail == atomic_load_explicit(&ring_head, memory_order_acquire)) {
+        return 0;
+    }
+    *command = ring[tail & (AUDIO_RING_SIZE - 1)];
+    atomic_store_explicit(&ring_tail, tail + 1, memory_order_release);
+    return 1;
+}
 
-        phase += phase_increment;
-        if (phase >= 2 * PI) {
-            phase -= 2 * PI;
+// Cleanup Audio, letting the game over tune finish first
+void cleanup_audio() {
+    if (audio_base) {
+        while (send_command(AUDIO_QUIT, 0) < 0) {
+            usleep(1000);
         }
+        pthread_join(audio_thread, NULL);
+        munmap((void *)audio_base, AUDIO_SPAN);
+        audio_base = NULL;
     }
 }
 
-static void *game_music_thread(void *arg) {
-    // Fast-paced melody notes (in Hz) for a game-like feel
-    float melody[] = {
-        261.63, 329.63, 392.00, 523.25, 440.00, 523.25, 587.33, 659.25, // C, E, G, C, A, C, D, E
-        698.46, 784.00, 880.00, 987.77, 1046.50, 1174.66, 1318.51, 1396.91, // F, G, A, B, C, D, E, F
-        1527.48, 1760.00, 1864.66, 1975.53, 2093.00, 2207.46, 2349.32, 2489.02  // G, A, B, C, D, E, F, G
-    };
-
-    // Durations in ms for a fast-paced tempo (most notes are shorter)
-    int durations[] = {
-        100, 100, 100, 100, 100, 100, 100, 100, // 8 fast notes (100ms each)
-        150, 150, 150, 150, 100, 100, 100, 100, // 4 slightly longer notes (150ms each)
-        120, 120, 100, 100, 100, 100, 100, 100  // Mix of 120ms and 100ms notes
-    };
-
-    music_running = true;
-
-    while (music_running) {
-        // Loop through the melody array and play the notes with their respective durations
-        for (int i = 0; i < sizeof(melody) / sizeof(melody[0]) && music_running; i++) {
-            play_sine_wave(melody[i], durations[i]);
+// Wait until at least AUDIO_REFILL_SAMPLES slots are free in both output FIFOs
+// and return how many are. Sleeps for the time the FIFO takes to drain that far
+// instead of polling the register.
+static int wait_fifo_space() {
+    unsigned int fifospace;
+    int left, right, space;
+    struct timespec drain = { 0, 0 };
+
+    while (1) {
+        fifospace = *(audio_base + AUDIO_FIFOSPACE);
+        left = (fifospace >> 24) & 0xFF;   // WSLC
+        right = (fifospace >> 16) & 0xFF;  // WSRC
+        space = (left < right) ? left : right;
+        if (space >= AUDIO_REFILL_SAMPLES) {
+            return space;
         }
+        drain.tv_nsec = (long)(AUDIO_REFILL_SAMPLES - space) * (1000000000 / SAMPLING_RATE);
+        nanosleep(&drain, NULL);
     }
-
-    return NULL;
 }
 
+// Let every music voice die away
+static void music_voices_release() {
+    for (int v = 0; v < MIXER_MUSIC_VOICES; v++) {
+        mixer_release(v);
+    }
+}
 
+// Ramp every music voice to a fade level
+static void music_voices_fade(int level, int ms) {
+    for (int v = 0; v < MIXER_MUSIC_VOICES; v++) {
+        mixer_fade(v, level, ms);
+    }
+}
 
-// Thread function for end game music (plays once, total duration 1 second)
-static void *game_over_thread(void *arg) {
-    // Melody (1D array with low frequencies for each note)
-    float melody[] = {
-        110.00, 130.81, 164.81, 174.61, 220.00, 196.00, // A2, C3, E3, F3, A3, G3
-        164.81, 174.61, 220.00, 196.00                  // E3, F3, A3, G3
-    };
-
-    // Durations for each note (still adds some variation for intensity)
-    int durations[] = {
-        200, 200, 300, 300, 400, 400, // Slow-paced but impactful
-        200, 300, 400, 500            // More emphasis on final notes
-    };
+// Audio thread: runs for the life of the program, takes commands between
+// bursts and keeps the FIFO fed with the mix of the current track and effects
+static void *audio_thread_main(void *arg) {
+    Sequencer track;
+    bool playing = false;
+    Waveform waveform = WAVE_SINE;
+    int tempo = 100;
+    AudioCommand command;
+    int16_t block[MIXER_MAX_BLOCK];
+    int fade_left = 0;          // Samples until a fade out ends the track
+    bool quitting = false;
+    int burst, next, i;
+
+    while (1) {
+        while (receive_command(&command)) {
+            switch (command.type) {
+            case AUDIO_PLAY_TRACK:
+                track = tracks[command.arg];
+                seq_set_tempo(&track, tempo);
+                playing = true;
+                fade_left = 0;
+                music_voices_fade(MIXER_GAIN_FULL, 0);
+                break;
+            case AUDIO_STOP:
+                playing = false;
+                music_voices_release();
+                break;
+            case AUDIO_FADE:
+                if (playing) {
+                    fade_left = (SAMPLING_RATE * command.arg) / 1000 + 1;
+                    music_voices_fade(0, command.arg);
+                }
+                break;
+            case AUDIO_SFX:
+                mixer_play_sfx(command.arg);
+                break;
+            case AUDIO_WAVEFORM:
+                waveform = command.arg;
+                break;
+            case AUDIO_TEMPO:
+                tempo = command.arg;
+                if (playing) {
+                    seq_set_tempo(&track, tempo);
+                }
+                break;
+            case AUDIO_QUIT:
+                quitting = true;
+                break;
+            }
+        }
+        if (quitting && (!playing || (track.flags & SEQ_LOOP))) {
+            break;
+        }
 
-    music_running = true;
+        // Fill the free FIFO slots, stopping where the next note is due
+        burst = wait_fifo_space();
+        if (burst > MIXER_MAX_BLOCK) {
+            burst = MIXER_MAX_BLOCK;
+        }
+        if (playing) {
+            next = seq_play_due(&track, waveform);
+            if (next < 0) {
+                playing = false;
+            } else if (burst > next) {
+                burst = next;
+            }
+        }
+        mixer_render(block, burst);
+        for (i = 0; i < burst; i++) {
+            int sample = block[i] * 65536;  // Scale the 16-bit mix to the 32-bit FIFO (a shift of a negative value is undefined)
+            *(audio_base + AUDIO_LEFTDATA) = sample;
+            *(audio_base + AUDIO_RIGHTDATA) = sample;
+        }
 
-    // Loop through melody array and play each note with its respective duration
-    for (int i = 0; i < sizeof(melody) / sizeof(melody[0]) && music_running; i++) {
-        play_sine_wave(melody[i], durations[i]);
+        if (playing) {
+            seq_advance(&track, burst);
+            if (fade_left > 0 && (fade_left -= burst) <= 0) {
+                playing = false;
+                music_voices_release();
+            }
+        }
     }
 
     return NULL;
 }
 
-
-
-
-
-
 // Set CPU affinity for a thread
 static void set_thread_cpu(pthread_t thread, int cpu_id) {
     cpu_set_t cpuset;
@@ -145,24 +270,45 @@ static void set_thread_cpu(pthread_t thread, int cpu_id) {
     }
 }
 
-// Start game music on a separate thread
+// Start the looping game music
 void play_game_music() {
-    if (music_running) return; // Prevent starting multiple threads
-
-    pthread_create(&music_thread, NULL, game_music_thread, NULL);
-    set_thread_cpu(music_thread, 1); // Assign to CPU core 1
+    send_command(AUDIO_PLAY_TRACK, TRACK_GAME_MUSIC);
 }
 
 // Stop game music
 void stop_game_music() {
-    music_running = false;
-    pthread_join(music_thread, NULL); // Wait for thread to terminate
+    send_command(AUDIO_STOP, 0);
+}
+
+// Fade the music out over duration_ms, then stop it
+void fade_game_music(int duration_ms) {
+    send_command(AUDIO_FADE, duration_ms);
 }
 
-// Play game over music on a separate thread
+// Play game over music once, in place of the game music
 void play_game_over() {
-    pthread_t game_over_thread_id;
-    pthread_create(&game_over_thread_id, NULL, game_over_thread, NULL);
-    set_thread_cpu(game_over_thread_id, 1); // Assign to CPU core 1
-    pthread_join(game_over_thread_id, NULL); // Wait for thread to terminate
+    send_command(AUDIO_PLAY_TRACK, TRACK_GAME_OVER);
+}
+
+// Set the music's speed in percent of its written tempo, for tunes that
+// follow the game's speed. Only sends a command when the speed changes.
+void set_music_tempo(int percent) {
+    if (percent < MUSIC_TEMPO_MIN) {
+        percent = MUSIC_TEMPO_MIN;
+    } else if (percent > MUSIC_TEMPO_MAX) {
+        percent = MUSIC_TEMPO_MAX;
+    }
+    if (percent != music_tempo && send_command(AUDIO_TEMPO, percent) == 0) {
+        music_tempo = percent;
+    }
+}
+
+// Select the waveform used for the music
+void set_music_waveform(Waveform wave) {
+    send_command(AUDIO_WAVEFORM, wave);
+}
+
+// Queue a sound effect
+void play_sfx(Sfx sfx) {
+    send_command(AUDIO_SFX, sfx);
 }
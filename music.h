@@ -1,6 +1,8 @@
 #ifndef MUSIC_H
 #define MUSIC_H
 
+#include "synth.h"
+#include "mixer.h"
 
 // Macros
 #define AUDIO_BASE 0xFF203040
@@ -12,14 +14,23 @@
 #define PAGE_SIZE 4096
 #define MAX_VOLUME 0x7FFFFFFF
 #define SAMPLING_RATE 8000
-#define PI 3.14159265358979323846
+#define AUDIO_REFILL_SAMPLES 64 // Free slots to wait for before a burst, half of each 128-sample FIFO (8 ms)
+#define MUSIC_TEMPO_MIN 50          // Range of set_music_tempo(), in percent
+#define MUSIC_TEMPO_MAX 200
+#define AUDIO_RING_SIZE 32          // Commands that can wait for the audio thread, a power of two
 
-// Function Prototypes
+// Function Prototypes. Everything but setup_audio() and cleanup_audio() only
+// queues a command for the audio thread and returns at once; call them from
+// the game loop thread.
 void setup_audio();
 void clear_audio_fifo();
 void cleanup_audio();
 void play_game_music();
 void stop_game_music();
+void fade_game_music(int duration_ms);
 void play_game_over();
+void set_music_waveform(Waveform wave);
+void set_music_tempo(int percent);
+void play_sfx(Sfx sfx);
 
 #endif // MUSIC_H
@@ -0,0 +1,57 @@
+#ifndef MUSIC_DATA_H
+#define MUSIC_DATA_H
+
+#include "sequencer.h"
+
+// The game's tunes, in the format described in sequencer.h. Both are written
+// at 125 beats per minute and 48 ticks per beat, so a tick is 10 ms.
+
+// Fast-paced melody for a game-like feel, loops and speeds up with the game
+static const unsigned char game_music_seq[] = {
+    'D', 'S', 'E', 'Q', SEQ_VERSION, SEQ_LOOP | SEQ_FOLLOW_TEMPO, 125, 48,
+    // delta, note, duration, voice, volume
+      0,  60,  10, 0, 128,     // C4
+     10,  64,  10, 0, 128,     // E4
+     10,  67,  10, 0, 128,     // G4
+     10,  72,  10, 0, 128,     // C5
+     10,  69,  10, 0, 128,     // A4
+     10,  72,  10, 0, 128,     // C5
+     10,  74,  10, 0, 128,     // D5
+     10,  76,  10, 0, 128,     // E5
+     10,  77,  15, 0, 128,     // F5
+     15,  79,  15, 0, 128,     // G5
+     15,  81,  15, 0, 128,     // A5
+     15,  83,  15, 0, 128,     // B5
+     15,  84,  10, 0, 128,     // C6
+     10,  86,  10, 0, 128,     // D6
+     10,  88,  10, 0, 128,     // E6
+     10,  89,  10, 0, 128,     // F6
+     10,  91,  12, 0, 128,     // G6
+     12,  93,  12, 0, 128,     // A6
+     12,  94,  10, 0, 128,     // A#6
+     10,  95,  10, 0, 128,     // B6
+     10,  96,  10, 0, 128,     // C7
+     10,  97,  10, 0, 128,     // C#7
+     10,  98,  10, 0, 128,     // D7
+     10,  99,  10, 0, 128,     // D#7
+     10, SEQ_END, 0, 0, 0,
+};
+
+// End game melody, slow-paced but impactful, plays once
+static const unsigned char game_over_seq[] = {
+    'D', 'S', 'E', 'Q', SEQ_VERSION, 0, 125, 48,
+    // delta, note, duration, voice, volume
+      0,  45,  20, 0, 128,     // A2
+     20,  48,  20, 0, 128,     // C3
+     20,  52,  30, 0, 128,     // E3
+     30,  53,  30, 0, 128,     // F3
+     30,  57,  40, 0, 128,     // A3
+     40,  55,  40, 0, 128,     // G3
+     40,  52,  20, 0, 128,     // E3
+     20,  53,  30, 0, 128,     // F3
+     30,  57,  40, 0, 128,     // A3
+     40,  55,  50, 0, 128,     // G3
+     50, SEQ_END, 0, 0, 0,
+};
+
+#endif // MUSIC_DATA_H
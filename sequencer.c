@@ -0,0 +1,113 @@
+/*Note sequence player*/
+#include <math.h>
+#include <string.h>
+#include "sequencer.h"
+#include "mixer.h"
+
+// Function to work out the length of a tick in samples, Q16
+static int64_t tick_length(const Sequencer *seq, int tempo) {
+    int percent = (seq->flags & SEQ_FOLLOW_TEMPO) ? seq->tempo_percent : 100;
+    return ((int64_t)seq->sample_rate * 60 * 100 << 16) /
+           ((int64_t)tempo * seq->ticks_per_beat * percent);
+}
+
+// Function to get the frequency of a MIDI note
+static float note_frequency(int note) {
+    return 440.0f * powf(2.0f, (note - 69) / 12.0f);
+}
+
+// Function to go back to the first event
+static void seq_rewind(Sequencer *seq) {
+    seq->next = seq->events;
+    seq->bpm = seq->tempo;
+    seq->tick = tick_length(seq, seq->bpm);
+    seq->until_next = seq->events[0] * seq->tick;
+}
+
+int seq_open(Sequencer *seq, const unsigned char *data, int size, int sample_rate) {
+    const unsigned char *event;
+    int ticks = 0;
+
+    if (size < SEQ_HEADER_BYTES || memcmp(data, "DSEQ", 4) != 0 || data[4] != SEQ_VERSION ||
+        data[6] == 0 || data[7] == 0) {
+        return -1;
+    }
+
+    // Every event must be whole and play on a music voice below half the
+    // sample rate, which the oscillator cannot go past, and the sequence must
+    // end and take some time, or a loop would never let go
+    for (event = data + SEQ_HEADER_BYTES; ; event += SEQ_EVENT_BYTES) {
+        if (event + SEQ_EVENT_BYTES > data + size) {
+            return -1;
+        }
+        ticks += event[0];
+        if (event[1] == SEQ_END) {
+            break;
+        }
+        if ((event[1] == SEQ_TEMPO && event[2] == 0) ||
+            (event[1] < SEQ_TEMPO && (event[1] > 127 || event[3] >= MIXER_MUSIC_VOICES ||
+                                      note_frequency(event[1]) >= sample_rate / 2))) {
+            return -1;
+        }
+    }
+    if (ticks == 0) {
+        return -1;
+    }
+
+    seq->events = data + SEQ_HEADER_BYTES;
+    seq->flags = data[5];
+    seq->tempo = data[6];
+    seq->ticks_per_beat = data[7];
+    seq->tempo_percent = 100;
+    seq->sample_rate = sample_rate;
+    seq_rewind(seq);
+    return 0;
+}
+
+void seq_set_tempo(Sequencer *seq, int percent) {
+    int64_t old_tick = seq->tick;
+
+    seq->tempo_percent = percent;
+    seq->tick = tick_length(seq, seq->bpm);
+
+    // Stretch the wait for the next event too, so the change is heard at once.
+    // Both are Q16 and a slow tempo makes them large enough for the product to
+    // overflow 64 bits, so scale in double, which keeps well under a Q16 step.
+    seq->until_next = (int64_t)((double)seq->until_next * seq->tick / old_tick);
+}
+
+int seq_play_due(Sequencer *seq, Waveform wave) {
+    const unsigned char *event;
+
+    while (seq->until_next <= 0) {
+        event = seq->next;
+        switch (event[1]) {
+        case SEQ_END:
+            if (!(seq->flags & SEQ_LOOP)) {
+                return -1;
+            }
+            seq->next = seq->events;
+            seq->bpm = seq->tempo;
+            seq->tick = tick_length(seq, seq->bpm);
+            break;
+        case SEQ_TEMPO:
+            seq->bpm = event[2];
+            seq->tick = tick_length(seq, seq->bpm);
+            seq->next += SEQ_EVENT_BYTES;
+            break;
+        default:
+            mixer_play_note(event[3], wave, note_frequency(event[1]), event[4] << 7,
+                            (int)((event[2] * seq->tick) >> 16));
+            seq->next += SEQ_EVENT_BYTES;
+            break;
+        }
+        seq->until_next += seq->next[0] * seq->tick;
+    }
+
+    // Round up, the event is due on the first sample at or after its time
+    return (int)((seq->until_next + 0xFFFF) >> 16);
+}
+
+void seq_advance(Sequencer *seq, int samples) {
+    seq->until_next -= (int64_t)samples << 16;
+}
@@ -0,0 +1,56 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdint.h>
+#include "synth.h"
+
+// Music is stored as note sequences and played by a sequencer that counts
+// time in samples, so notes start on the exact sample they are due and a
+// tempo change takes effect straight away.
+//
+// Sequence layout:
+//   header:  "DSEQ", uint8 version, uint8 flags, uint8 tempo (beats per
+//            minute), uint8 ticks per beat
+//   events:  uint8 delta (ticks since the previous event), uint8 note,
+//            uint8 duration (ticks), uint8 voice, uint8 volume (0-255)
+// A note is a MIDI note number. SEQ_TEMPO sets the tempo to its duration
+// byte, and SEQ_END ends the sequence, after its delta, or starts it again.
+
+#define SEQ_VERSION 1
+#define SEQ_HEADER_BYTES 8
+#define SEQ_EVENT_BYTES 5
+
+#define SEQ_LOOP 0x01               // Flag: start again at the end
+#define SEQ_FOLLOW_TEMPO 0x02       // Flag: the tempo follows seq_set_tempo()
+
+#define SEQ_TEMPO 0xFE
+#define SEQ_END 0xFF
+
+typedef struct {
+    const unsigned char *events;    // First event
+    const unsigned char *next;      // Next event to play
+    int flags;
+    int tempo;                      // Beats per minute, as written in the header
+    int bpm;                        // Beats per minute now, after any SEQ_TEMPO events
+    int ticks_per_beat;
+    int tempo_percent;              // Playback speed when following the tempo
+    int64_t tick;                   // Samples per tick, Q16
+    int64_t until_next;             // Samples until the next event, Q16
+    int sample_rate;
+} Sequencer;
+
+// Function to check a sequence and get ready to play it from the start,
+// returns -1 if the data is not a sequence this version can play
+int seq_open(Sequencer *seq, const unsigned char *data, int size, int sample_rate);
+
+// Function to set the playback speed in percent, for sequences that follow the tempo
+void seq_set_tempo(Sequencer *seq, int percent);
+
+// Function to start every note that is due on the mixer, returns the samples
+// until the next event or -1 once a sequence that does not loop has ended
+int seq_play_due(Sequencer *seq, Waveform wave);
+
+// Function to move the sequence on by samples, at most what seq_play_due() returned
+void seq_advance(Sequencer *seq, int samples);
+
+#endif // SEQUENCER_H
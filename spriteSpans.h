@@ -0,0 +1,150 @@
+// spriteSpans.h
+// Generated by genSpans from pixelArrays.h, do not edit by hand.
+// Each row of a sprite is a list of opaque runs (x offset, length) so the
+// blitter can copy whole runs and skip transparent (0x2D9D) pixels.
+#ifndef SPRITE_SPANS_H
+#define SPRITE_SPANS_H
+
+struct sprite_span {
+    unsigned short x, len;
+};
+
+static const unsigned short DogRun1_rows[34] = {
+    0, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 23, 25, 27, 29,
+    30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 41, 43, 45, 47, 49, 51,
+    53, 55
+};
+static const struct sprite_span DogRun1_spans[55] = {
+    {5, 1}, {38, 7}, {4, 2}, {35, 11}, {4, 3}, {34, 13}, {4, 3}, {33, 14},
+    {3, 4}, {32, 17}, {3, 4}, {31, 18}, {3, 5}, {30, 21}, {3, 5}, {30, 22},
+    {3, 6}, {30, 22}, {3, 7}, {30, 22}, {4, 7}, {14, 8}, {31, 20}, {4, 21},
+    {31, 20}, {6, 20}, {33, 12}, {6, 25}, {33, 11}, {7, 37}, {7, 37}, {6, 38},
+    {6, 38}, {6, 40}, {5, 42}, {5, 43}, {5, 44}, {6, 44}, {6, 44}, {7, 37},
+    {45, 5}, {7, 37}, {45, 5}, {8, 12}, {27, 22}, {9, 10}, {39, 7}, {9, 9},
+    {40, 6}, {10, 7}, {40, 7}, {10, 7}, {41, 6}, {11, 5}, {42, 5}
+};
+
+static const unsigned short DogRun2_rows[34] = {
+    0, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 28,
+    29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 41, 43, 45, 49, 51,
+    52, 53
+};
+static const struct sprite_span DogRun2_spans[53] = {
+    {38, 7}, {4, 1}, {35, 11}, {3, 2}, {34, 13}, {3, 2}, {33, 14}, {3, 3},
+    {32, 17}, {3, 3}, {31, 18}, {3, 3}, {30, 21}, {3, 3}, {30, 22}, {3, 4},
+    {30, 22}, {2, 6}, {30, 22}, {2, 7}, {31, 20}, {3, 6}, {31, 20}, {3, 15},
+    {33, 12}, {5, 24}, {33, 11}, {5, 38}, {6, 36}, {6, 35}, {6, 35}, {5, 36},
+    {5, 36}, {4, 37}, {4, 37}, {4, 36}, {4, 35}, {4, 35}, {4, 34}, {5, 11},
+    {29, 9}, {6, 10}, {28, 10}, {6, 10}, {26, 12}, {7, 4}, {12, 6}, {26, 6},
+    {34, 2}, {7, 12}, {26, 5}, {8, 11}, {10, 4}
+};
+
+static const unsigned short DogRun3_rows[34] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 9, 11, 14, 17, 20, 23, 25, 27,
+    28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 39, 41, 43, 45, 48, 51,
+    53, 55
+};
+static const struct sprite_span DogRun3_spans[55] = {
+    {34, 6}, {31, 11}, {29, 17}, {27, 20}, {27, 20}, {27, 20}, {29, 20}, {0, 1},
+    {28, 21}, {0, 3}, {28, 23}, {0, 4}, {28, 10}, {39, 13}, {0, 5}, {28, 8},
+    {38, 14}, {1, 7}, {29, 6}, {37, 15}, {2, 8}, {30, 3}, {36, 16}, {3, 9},
+    {35, 17}, {4, 12}, {31, 20}, {5, 39}, {7, 37}, {8, 36}, {9, 35}, {9, 35},
+    {7, 41}, {6, 43}, {6, 44}, {4, 47}, {4, 47}, {3, 43}, {47, 4}, {3, 14},
+    {18, 28}, {2, 15}, {27, 19}, {1, 16}, {29, 19}, {0, 6}, {9, 8}, {41, 7},
+    {0, 6}, {9, 7}, {42, 6}, {0, 5}, {9, 5}, {0, 5}, {10, 2}
+};
+
+static const unsigned short Dog_Crouch_rows[20] = {
+    0, 2, 4, 6, 8, 10, 12, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+    24, 25, 27, 29
+};
+static const struct sprite_span Dog_Crouch_spans[29] = {
+    {0, 2}, {40, 8}, {0, 2}, {40, 9}, {0, 2}, {39, 10}, {0, 4}, {38, 12},
+    {0, 4}, {37, 13}, {0, 5}, {36, 16}, {0, 7}, {9, 6}, {36, 18}, {2, 52},
+    {2, 52}, {4, 50}, {4, 49}, {4, 42}, {4, 42}, {4, 43}, {3, 50}, {3, 50},
+    {3, 50}, {4, 13}, {24, 20}, {6, 11}, {36, 8}
+};
+
+static const unsigned short Cat_rows[37] = {
+    0, 2, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+    18, 19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 38, 39, 40, 41, 42,
+    43, 44, 45, 47, 49
+};
+static const struct sprite_span Cat_spans[49] = {
+    {5, 4}, {20, 3}, {5, 4}, {20, 3}, {5, 19}, {5, 20}, {5, 20}, {5, 20},
+    {5, 20}, {5, 20}, {5, 20}, {3, 22}, {3, 22}, {3, 22}, {3, 22}, {5, 20},
+    {1, 23}, {1, 23}, {0, 22}, {0, 22}, {28, 2}, {1, 22}, {26, 5}, {2, 22},
+    {25, 7}, {3, 21}, {25, 7}, {3, 21}, {25, 7}, {5, 19}, {25, 7}, {5, 19},
+    {25, 7}, {5, 19}, {25, 7}, {5, 19}, {25, 7}, {5, 26}, {5, 26}, {4, 26},
+    {4, 26}, {3, 26}, {3, 25}, {3, 22}, {3, 21}, {3, 9}, {15, 8}, {4, 5},
+    {16, 6}
+};
+
+static const unsigned short Mushroom_rows[41] = {
+    0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30,
+    31, 32, 33, 34, 35, 36, 37, 38, 39
+};
+static const struct sprite_span Mushroom_spans[39] = {
+    {13, 12}, {12, 13}, {11, 16}, {11, 16}, {8, 22}, {7, 25}, {7, 25}, {5, 29},
+    {3, 32}, {3, 32}, {3, 32}, {2, 35}, {2, 35}, {0, 37}, {0, 38}, {0, 38},
+    {0, 39}, {0, 39}, {0, 39}, {0, 39}, {1, 36}, {2, 35}, {2, 34}, {3, 31},
+    {8, 22}, {8, 22}, {11, 16}, {11, 16}, {11, 16}, {11, 16}, {11, 16}, {11, 16},
+    {11, 16}, {11, 16}, {11, 16}, {11, 16}, {11, 16}, {11, 16}, {11, 16}
+};
+
+static const unsigned short Crystal_rows[201] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+    80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 93, 95, 97, 99,
+    101, 103, 105, 107, 109, 111, 113, 115, 116, 117, 118, 119, 121, 123, 125, 128,
+    131, 134, 136, 138, 140, 142, 144, 146, 148, 150, 153, 155, 157, 160, 163, 166,
+    167, 168, 169, 170, 171, 173, 175, 177, 178, 179, 181, 182, 183, 185, 186, 188,
+    189, 191, 193, 194, 195, 196, 198, 200, 201, 202, 204, 205, 206, 207, 208, 209,
+    210, 211, 212, 213, 214, 215, 216, 218, 220, 222, 225, 227, 229, 231, 233, 235,
+    237, 239, 241, 244, 246, 248, 251, 253, 255, 257, 258, 259, 260, 261, 262, 264,
+    267, 269, 271, 273, 275, 277, 279, 281, 283
+};
+static const struct sprite_span Crystal_spans[283] = {
+    {14, 39}, {14, 38}, {13, 40}, {13, 40}, {13, 40}, {11, 42}, {11, 42}, {11, 42},
+    {10, 45}, {10, 45}, {10, 46}, {10, 45}, {10, 45}, {9, 47}, {9, 47}, {9, 47},
+    {9, 47}, {9, 47}, {9, 47}, {8, 49}, {8, 49}, {6, 52}, {6, 52}, {6, 52},
+    {6, 54}, {6, 54}, {6, 54}, {5, 55}, {5, 55}, {4, 56}, {4, 56}, {4, 56},
+    {4, 56}, {4, 56}, {4, 56}, {3, 57}, {3, 57}, {1, 59}, {1, 59}, {1, 59},
+    {1, 59}, {1, 59}, {1, 59}, {1, 59}, {1, 59}, {1, 59}, {0, 60}, {0, 60},
+    {0, 58}, {0, 58}, {0, 58}, {0, 57}, {0, 57}, {0, 57}, {0, 53}, {0, 53},
+    {0, 55}, {0, 55}, {0, 55}, {0, 55}, {0, 55}, {0, 55}, {0, 57}, {0, 57},
+    {0, 57}, {0, 57}, {0, 57}, {0, 57}, {0, 57}, {0, 57}, {0, 57}, {0, 57},
+    {0, 57}, {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58},
+    {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58}, {0, 58},
+    {0, 58}, {0, 58}, {0, 58}, {1, 10}, {14, 44}, {1, 10}, {14, 44}, {1, 10},
+    {14, 44}, {3, 7}, {14, 44}, {3, 7}, {14, 44}, {3, 7}, {14, 44}, {4, 6},
+    {14, 44}, {4, 4}, {14, 44}, {4, 3}, {14, 44}, {4, 3}, {14, 44}, {5, 1},
+    {14, 44}, {5, 1}, {14, 43}, {14, 43}, {14, 43}, {14, 43}, {14, 43}, {5, 1},
+    {14, 43}, {4, 5}, {14, 43}, {3, 4}, {14, 43}, {4, 3}, {14, 30}, {46, 11},
+    {5, 2}, {14, 30}, {46, 11}, {5, 1}, {14, 30}, {46, 11}, {14, 30}, {46, 11},
+    {14, 30}, {46, 11}, {14, 30}, {47, 10}, {14, 30}, {47, 10}, {14, 30}, {47, 10},
+    {13, 31}, {48, 7}, {13, 31}, {48, 7}, {13, 31}, {48, 7}, {13, 31}, {48, 1},
+    {50, 5}, {13, 31}, {50, 5}, {13, 31}, {50, 5}, {9, 1}, {13, 31}, {51, 3},
+    {8, 2}, {13, 31}, {52, 2}, {7, 2}, {13, 31}, {52, 1}, {13, 31}, {13, 31},
+    {13, 31}, {13, 31}, {13, 31}, {13, 31}, {57, 1}, {13, 31}, {56, 1}, {13, 31},
+    {57, 1}, {13, 31}, {13, 31}, {0, 1}, {13, 31}, {13, 31}, {13, 31}, {13, 31},
+    {48, 1}, {13, 31}, {13, 31}, {50, 1}, {14, 30}, {14, 30}, {56, 1}, {14, 30},
+    {56, 1}, {14, 30}, {14, 30}, {14, 30}, {5, 1}, {14, 30}, {6, 1}, {14, 30},
+    {14, 30}, {14, 30}, {14, 29}, {55, 1}, {14, 29}, {14, 29}, {14, 29}, {14, 29},
+    {14, 29}, {14, 29}, {14, 29}, {14, 29}, {15, 27}, {15, 27}, {15, 27}, {15, 27},
+    {15, 27}, {56, 1}, {10, 1}, {15, 26}, {2, 1}, {15, 26}, {1, 1}, {15, 26},
+    {47, 2}, {17, 22}, {46, 2}, {12, 1}, {17, 22}, {12, 1}, {18, 21}, {5, 1},
+    {18, 21}, {5, 2}, {18, 21}, {4, 4}, {18, 20}, {1, 8}, {18, 20}, {2, 7},
+    {18, 20}, {4, 6}, {19, 18}, {56, 1}, {4, 2}, {19, 18}, {5, 1}, {19, 18},
+    {5, 1}, {11, 1}, {19, 18}, {5, 1}, {19, 18}, {20, 16}, {41, 2}, {20, 16},
+    {42, 1}, {20, 16}, {20, 16}, {20, 16}, {20, 16}, {22, 11}, {3, 1}, {22, 11},
+    {4, 1}, {12, 1}, {22, 11}, {22, 11}, {51, 1}, {22, 11}, {51, 1}, {23, 9},
+    {50, 4}, {23, 9}, {49, 6}, {23, 9}, {47, 7}, {23, 9}, {50, 3}, {23, 9},
+    {51, 2}, {24, 7}, {51, 2}
+};
+
+#endif // SPRITE_SPANS_H
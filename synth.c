@@ -0,0 +1,25 @@
+/*Wavetable synthesis*/
+#include <math.h>
+#include "synth.h"
+
+#define TWO_PI 6.28318530717958647692
+
+int16_t wavetables[NUM_WAVEFORMS][WAVETABLE_SIZE + 1];
+
+void synth_init(void) {
+    int i;
+    double t;
+
+    for (i = 0; i <= WAVETABLE_SIZE; i++) {
+        t = (double)(i % WAVETABLE_SIZE) / WAVETABLE_SIZE;   // Position in the cycle, 0 to 1
+        wavetables[WAVE_SINE][i] = (int16_t)lrint(32767.0 * sin(TWO_PI * t));
+        wavetables[WAVE_SQUARE][i] = (t < 0.5) ? 32767 : -32767;
+        wavetables[WAVE_TRIANGLE][i] = (int16_t)lrint(32767.0 * (t < 0.5 ? 4.0 * t - 1.0 : 3.0 - 4.0 * t));
+        wavetables[WAVE_SAW][i] = (int16_t)lrint(32767.0 * (2.0 * t - 1.0));
+    }
+}
+
+void osc_set(Oscillator *osc, Waveform wave, float frequency, int sample_rate) {
+    osc->table = wavetables[wave];
+    osc->increment = (uint32_t)(frequency * 4294967296.0 / sample_rate);
+}
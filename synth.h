@@ -0,0 +1,48 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include <stdint.h>
+
+// Wavetable oscillators. Each table holds one cycle of a waveform as 16-bit
+// samples, with one extra entry so interpolation never has to wrap. The
+// phase is a 32-bit fixed-point fraction of a cycle: the top WAVETABLE_BITS
+// pick the table entry and the next 15 bits interpolate to the following one.
+#define WAVETABLE_BITS 8
+#define WAVETABLE_SIZE (1 << WAVETABLE_BITS)
+#define PHASE_FRAC_BITS 15
+
+typedef enum {
+    WAVE_SINE,
+    WAVE_SQUARE,
+    WAVE_TRIANGLE,
+    WAVE_SAW,
+    NUM_WAVEFORMS
+} Waveform;
+
+typedef struct {
+    uint32_t phase;
+    uint32_t increment;         // Phase step per sample, sets the frequency
+    const int16_t *table;
+} Oscillator;
+
+extern int16_t wavetables[NUM_WAVEFORMS][WAVETABLE_SIZE + 1];
+
+// Function to fill the wavetables, call once before using an oscillator
+void synth_init(void);
+
+// Function to set an oscillator's waveform and frequency, keeping its phase
+// so a change of note does not click
+void osc_set(Oscillator *osc, Waveform wave, float frequency, int sample_rate);
+
+// Function to get the oscillator's next sample, full scale is +-32767
+static inline int32_t osc_next(Oscillator *osc) {
+    uint32_t index = osc->phase >> (32 - WAVETABLE_BITS);
+    int32_t frac = (osc->phase >> (32 - WAVETABLE_BITS - PHASE_FRAC_BITS)) & ((1 << PHASE_FRAC_BITS) - 1);
+    int32_t a = osc->table[index];
+    int32_t b = osc->table[index + 1];
+
+    osc->phase += osc->increment;
+    return a + (((b - a) * frac) >> PHASE_FRAC_BITS);
+}
+
+#endif // SYNTH_H
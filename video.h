@@ -0,0 +1,82 @@
+// video.h
+// Interface shared by the /dev/video driver and the user-level game
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#ifdef __KERNEL__
+#include <linux/types.h>
+#else
+#include <stdint.h>
+#endif
+#include <linux/ioctl.h>
+
+// Pixel buffers are 512x256 RGB565 with 1024-byte rows: (y << 10) + (x << 1)
+#define VIDEO_ROW_BYTES 1024
+#define VIDEO_FRAME_BYTES (VIDEO_ROW_BYTES * 256)
+
+// mmap() of /dev/video at offset 0 maps the pixel buffers back to back,
+// VIDEO_FRAME_BYTES apart, in the order given here. The second SDRAM buffer
+// is only used when the driver is loaded with num_buffers=3.
+#define VIDEO_MAX_BUFFERS 3
+enum video_buffer {
+    VIDEO_BUF_SDRAM,
+    VIDEO_BUF_ONCHIP,
+    VIDEO_BUF_SDRAM2
+};
+
+// Buffer swaps are asynchronous: a sync command or VIDEO_IOC_FLIP only queues
+// the finished frame for display. Drawing commands wait until a buffer is
+// free to draw into, and poll() reports POLLOUT once one is. With two buffers
+// that means waiting for the swap to land, with three only when two finished
+// frames are already waiting to be shown.
+#define VIDEO_IOC_MAGIC 'v'
+#define VIDEO_IOC_GET_BACK _IOR(VIDEO_IOC_MAGIC, 1, int)   // Back buffer index, waits for a swap
+#define VIDEO_IOC_SYNC     _IOR(VIDEO_IOC_MAGIC, 2, int)   // Swap, wait, then as GET_BACK
+#define VIDEO_IOC_FLIP     _IO(VIDEO_IOC_MAGIC, 3)         // Request a swap and return at once
+
+// A binary batch is a sequence of 16-bit words. The first word is the magic
+// number, followed by commands of the form: VIDEO_CMD(op, nargs), arg0, ...
+// The low byte of the magic is not printable, so the driver can tell a batch
+// apart from the text commands ("clear", "sync", "box ...") used for debugging.
+#define VIDEO_BATCH_MAGIC 0xB1A5
+#define VIDEO_BATCH_BYTES 4096
+#define VIDEO_BATCH_WORDS (VIDEO_BATCH_BYTES / 2)
+
+#define VIDEO_CMD(op, nargs) ((uint16_t)((op) | ((nargs) << 8)))
+#define VIDEO_CMD_OP(word) ((word) & 0xFF)
+#define VIDEO_CMD_NARGS(word) (((word) >> 8) & 0xFF)
+
+// Longest string a single text command can carry
+#define VIDEO_TEXT_MAX 255
+
+// Command opcodes and their arguments
+enum video_op {
+    VIDEO_OP_CLEAR = 1,         // no arguments
+    VIDEO_OP_SPRITE,            // sprite id, x, y
+    VIDEO_OP_PIXEL,             // x, y, color
+    VIDEO_OP_LINE,              // x0, y0, x1, y1, color
+    VIDEO_OP_BOX,               // x0, y0, x1, y1, color
+    VIDEO_OP_TEXT,              // x, y, length, then two characters per word
+    VIDEO_OP_ERASE,             // no arguments
+    VIDEO_OP_TOP_BACKGROUND,    // no arguments
+    VIDEO_OP_SYNC,              // no arguments
+    VIDEO_OP_RESTORE,           // no arguments, clears only what was drawn last time
+    VIDEO_OP_SAVE_BACKGROUND,   // no arguments, back buffer becomes what restore goes back to
+    VIDEO_NUM_OPS
+};
+
+// Sprite ids used by VIDEO_OP_SPRITE
+enum video_sprite {
+    SPRITE_DOGRUN1,
+    SPRITE_DOGRUN2,
+    SPRITE_DOGRUN3,
+    SPRITE_DOG_CROUCH,
+    SPRITE_CAT,
+    SPRITE_MUSHROOM,
+    SPRITE_CRYSTAL,
+    SPRITE_GRASS,
+    SPRITE_POND,
+    NUM_SPRITES
+};
+
+#endif // VIDEO_H
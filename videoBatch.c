@@ -0,0 +1,104 @@
+/*Binary display list encoder for the /dev/video driver*/
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "videoBatch.h"
+
+// Function to append a command and its arguments, dropping it if the batch is full
+static void batch_command(VideoBatch *batch, int op, const int *args, int nargs) {
+    int i;
+    if (batch->count + 1 + nargs > VIDEO_BATCH_WORDS) {
+        fprintf(stderr, "Video batch full, dropping command %d\n", op);
+        return;
+    }
+    batch->words[batch->count++] = VIDEO_CMD(op, nargs);
+    for (i = 0; i < nargs; i++) {
+        batch->words[batch->count++] = (uint16_t)args[i];
+    }
+}
+
+void batch_begin(VideoBatch *batch) {
+    batch->words[0] = VIDEO_BATCH_MAGIC;
+    batch->count = 1;
+}
+
+void batch_clear(VideoBatch *batch) {
+    batch_command(batch, VIDEO_OP_CLEAR, NULL, 0);
+}
+
+void batch_restore(VideoBatch *batch) {
+    batch_command(batch, VIDEO_OP_RESTORE, NULL, 0);
+}
+
+void batch_save_background(VideoBatch *batch) {
+    batch_command(batch, VIDEO_OP_SAVE_BACKGROUND, NULL, 0);
+}
+
+void batch_sprite(VideoBatch *batch, int sprite, int x, int y) {
+    int args[3] = {sprite, x, y};
+    batch_command(batch, VIDEO_OP_SPRITE, args, 3);
+}
+
+void batch_pixel(VideoBatch *batch, int x, int y, short int color) {
+    int args[3] = {x, y, color};
+    batch_command(batch, VIDEO_OP_PIXEL, args, 3);
+}
+
+void batch_line(VideoBatch *batch, int x0, int y0, int x1, int y1, short int color) {
+    int args[5] = {x0, y0, x1, y1, color};
+    batch_command(batch, VIDEO_OP_LINE, args, 5);
+}
+
+void batch_box(VideoBatch *batch, int x0, int y0, int x1, int y1, short int color) {
+    int args[5] = {x0, y0, x1, y1, color};
+    batch_command(batch, VIDEO_OP_BOX, args, 5);
+}
+
+void batch_text(VideoBatch *batch, int x, int y, const char *str) {
+    int len = strlen(str);
+    int nargs;
+
+    if (len > VIDEO_TEXT_MAX) {
+        len = VIDEO_TEXT_MAX;
+    }
+    nargs = 3 + (len + 1) / 2;
+    if (batch->count + 1 + nargs > VIDEO_BATCH_WORDS) {
+        fprintf(stderr, "Video batch full, dropping text\n");
+        return;
+    }
+
+    // Header words, then the characters packed two per word
+    batch->words[batch->count++] = VIDEO_CMD(VIDEO_OP_TEXT, nargs);
+    batch->words[batch->count++] = (uint16_t)x;
+    batch->words[batch->count++] = (uint16_t)y;
+    batch->words[batch->count++] = (uint16_t)len;
+    if (len % 2) {
+        batch->words[batch->count + nargs - 4] = 0; // Pad odd lengths with a zero byte
+    }
+    memcpy(&batch->words[batch->count], str, len);
+    batch->count += nargs - 3;
+}
+
+void batch_erase(VideoBatch *batch) {
+    batch_command(batch, VIDEO_OP_ERASE, NULL, 0);
+}
+
+void batch_top_background(VideoBatch *batch) {
+    batch_command(batch, VIDEO_OP_TOP_BACKGROUND, NULL, 0);
+}
+
+void batch_sync(VideoBatch *batch) {
+    batch_command(batch, VIDEO_OP_SYNC, NULL, 0);
+}
+
+int batch_submit(VideoBatch *batch, int video_FD) {
+    int result = 0;
+    if (batch->count > 1) {
+        result = write(video_FD, batch->words, batch->count * sizeof(uint16_t));
+        if (result == -1) {
+            perror("Failed to write video batch");
+        }
+    }
+    batch_begin(batch);
+    return result;
+}
@@ -0,0 +1,31 @@
+#ifndef VIDEO_BATCH_H
+#define VIDEO_BATCH_H
+
+#include "video.h"
+
+// Display list built up over a frame and submitted with a single write()
+typedef struct {
+    uint16_t words[VIDEO_BATCH_WORDS];
+    int count;
+} VideoBatch;
+
+// Function to start a new (empty) batch
+void batch_begin(VideoBatch *batch);
+
+// Functions to append commands to the batch
+void batch_clear(VideoBatch *batch);
+void batch_restore(VideoBatch *batch);
+void batch_save_background(VideoBatch *batch);
+void batch_sprite(VideoBatch *batch, int sprite, int x, int y);
+void batch_pixel(VideoBatch *batch, int x, int y, short int color);
+void batch_line(VideoBatch *batch, int x0, int y0, int x1, int y1, short int color);
+void batch_box(VideoBatch *batch, int x0, int y0, int x1, int y1, short int color);
+void batch_text(VideoBatch *batch, int x, int y, const char *str);
+void batch_erase(VideoBatch *batch);
+void batch_top_background(VideoBatch *batch);
+void batch_sync(VideoBatch *batch);
+
+// Function to send the batch to the video driver, returns the write() result
+int batch_submit(VideoBatch *batch, int video_FD);
+
+#endif // VIDEO_BATCH_H
@@ -0,0 +1,121 @@
+/*Rendering microbenchmarks, run against the simulated framebuffer*/
+// Each benchmark calls one drawing primitive repeatedly until at least
+// MIN_RUN_NS has passed, then prints one CSV line:
+//   name,calls,ns_per_call,pixels_per_call,mpixels_per_sec
+// Pixels are counted by the primitives themselves (pixels_written), so the
+// figures match the driver's debugfs statistics.
+#include <stdio.h>
+#include <string.h>
+#include "videoSim.h"
+#include "videoDraw.h"
+#include "videoBatch.h"
+
+#define MIN_RUN_NS 200000000LL  // Run each benchmark for at least 0.2 s
+#define BATCH_CALLS 64          // Calls between clock reads
+
+typedef void (*BenchFn)(int i);
+
+static int bench_sprite_id;
+
+// Function to time fn, calling it with an increasing counter
+static void run_bench(const char *name, BenchFn fn) {
+    long long calls = 0, start, elapsed;
+    u64 pixels;
+    int i;
+
+    // Warm up caches and reset the dirty lists so every run starts the same way
+    for (i = 0; i < BATCH_CALLS; i++)
+        fn(i);
+    clear_screen();
+
+    pixels = pixels_written;
+    start = draw_now_ns();
+    do {
+        for (i = 0; i < BATCH_CALLS; i++)
+            fn(calls + i);
+        calls += BATCH_CALLS;
+        elapsed = draw_now_ns() - start;
+    } while (elapsed < MIN_RUN_NS);
+    pixels = pixels_written - pixels;
+
+    printf("%s,%lld,%.1f,%.1f,%.2f\n", name, calls, (double)elapsed / calls,
+           (double)pixels / calls, pixels * 1000.0 / elapsed);
+}
+
+static void bench_plot_pixel(int i) {
+    plot_pixel(i % SIM_WIDTH, TOP_CUTOFF + (i / SIM_WIDTH) % (SIM_HEIGHT - TOP_CUTOFF), i);
+}
+
+static void bench_draw_line(int i) {
+    // Alternate shallow and steep lines across the playfield
+    if (i & 1)
+        draw_line(0, TOP_CUTOFF + i % 100, SIM_WIDTH - 1, SIM_HEIGHT - 1 - i % 100, 0xF800);
+    else
+        draw_line(i % 200, TOP_CUTOFF, SIM_WIDTH - 1 - i % 200, SIM_HEIGHT - 1, 0x07E0);
+}
+
+static void bench_draw_box(int i) {
+    int x = (i * 37) % (SIM_WIDTH - 32);
+    int y = TOP_CUTOFF + (i * 11) % (SIM_HEIGHT - TOP_CUTOFF - 32);
+    draw_box(x, y, x + 31, y + 31, 0x001F);
+}
+
+static void bench_clear_screen(int i) {
+    clear_screen();
+}
+
+static void bench_sprite(int i) {
+    draw_sprite(bench_sprite_id, (i * 7) % 200, 120);
+}
+
+static void bench_write_string(int i) {
+    write_string(2, 2 + i % 4, "Score: 12345");
+}
+
+// A frame as final.c sends it: restore, obstacles, the player and the score
+static VideoBatch frame;
+
+static void bench_frame(int i) {
+    sim_write(frame.words, frame.count * sizeof(uint16_t));
+}
+
+int main(void) {
+    char name[64];
+    int id, x;
+
+    if (sim_open(2) < 0)
+        return 1;
+
+    // Same start of game as final.c, so restore has a background to go back to
+    batch_begin(&frame);
+    batch_top_background(&frame);
+    batch_clear(&frame);
+    for (x = 0; x < SIM_WIDTH; x += 56)
+        batch_sprite(&frame, SPRITE_GRASS, x, 221);
+    batch_save_background(&frame);
+    sim_write(frame.words, frame.count * sizeof(uint16_t));
+
+    batch_begin(&frame);
+    batch_restore(&frame);
+    batch_sprite(&frame, SPRITE_CAT, 200, 185);
+    batch_sprite(&frame, SPRITE_MUSHROOM, 280, 181);
+    batch_sprite(&frame, SPRITE_DOGRUN2, 20, 188);
+    batch_text(&frame, 2, 2, "Score: 12345");
+    batch_sync(&frame);
+
+    printf("name,calls,ns_per_call,pixels_per_call,mpixels_per_sec\n");
+    run_bench("plot_pixel", bench_plot_pixel);
+    run_bench("draw_line", bench_draw_line);
+    run_bench("draw_box_32x32", bench_draw_box);
+    run_bench("clear_screen", bench_clear_screen);
+    for (id = 0; id < NUM_SPRITES; id++) {
+        bench_sprite_id = id;
+        snprintf(name, sizeof(name), "sprite_%s", sprite_name(id));
+        run_bench(name, bench_sprite);
+    }
+    run_bench("write_string", bench_write_string);
+    run_bench("frame", bench_frame);
+
+    sim_close();
+    return 0;
+}
@@ -0,0 +1,614 @@
+// videoDraw.c
+// Drawing core of the video driver: text and binary commands, fills, lines,
+// sprites and the character buffer. Built into video.ko and into the
+// user-space simulator (videoSim.c), see videoDraw.h.
+#include "videoDraw.h"
+#ifdef CONFIG_KERNEL_MODE_NEON
+#include <asm/neon.h>
+#endif
+#include "pixelArrays.h"
+#include "spriteSpans.h"
+
+#define NEON_MIN_PIXELS 64      // Narrower fills are not worth saving the NEON state
+
+unsigned long pixel_buffer, character_buffer;
+int resolution_x, resolution_y;
+int char_resolution_x = 80, char_resolution_y = 60;     // Default character buffer resolution
+int back_buffer;
+struct dirty_list dirty[VIDEO_MAX_BUFFERS];
+u16 *background;
+int background_valid;
+struct command_stats cmd_stats[VIDEO_NUM_OPS];
+u64 pixels_written;
+u64 invalid_commands;
+
+const char *const op_names[VIDEO_NUM_OPS] = {
+    [VIDEO_OP_CLEAR] = "clear",
+    [VIDEO_OP_SPRITE] = "sprite",
+    [VIDEO_OP_PIXEL] = "pixel",
+    [VIDEO_OP_LINE] = "line",
+    [VIDEO_OP_BOX] = "box",
+    [VIDEO_OP_TEXT] = "text",
+    [VIDEO_OP_ERASE] = "erase",
+    [VIDEO_OP_TOP_BACKGROUND] = "TopBackground",
+    [VIDEO_OP_SYNC] = "sync",
+    [VIDEO_OP_RESTORE] = "restore",
+    [VIDEO_OP_SAVE_BACKGROUND] = "savebg",
+};
+
+// Sprite table, indexed by the sprite ids in video.h. Sprites with a
+// transparency key are drawn from their opaque runs in spriteSpans.h, or
+// pixel by pixel if no span table has been generated for them yet.
+struct sprite {
+    const char *name;                   // Name used by the text commands
+    int width, height;
+    const unsigned short *data;
+    int key;                            // Transparent color, -1 for opaque sprites
+    const unsigned short *rows;         // First span of each row, NULL without spans
+    const struct sprite_span *spans;
+};
+
+static const struct sprite sprites[NUM_SPRITES] = {
+    [SPRITE_DOGRUN1] = { "DogRun1", DOGRUN_WIDTH, DOGRUN_HEIGHT, &DogRun1[0][0],
+                         0x2D9D, DogRun1_rows, DogRun1_spans },
+    [SPRITE_DOGRUN2] = { "DogRun2", DOGRUN_WIDTH, DOGRUN_HEIGHT, &DogRun2[0][0],
+                         0x2D9D, DogRun2_rows, DogRun2_spans },
+    [SPRITE_DOGRUN3] = { "DogRun3", DOGRUN_WIDTH, DOGRUN_HEIGHT, &DogRun3[0][0],
+                         0x2D9D, DogRun3_rows, DogRun3_spans },
+    [SPRITE_DOG_CROUCH] = { "DogCrouch", DOG_CROUCH_WIDTH, DOG_CROUCH_HEIGHT, &Dog_Crouch[0][0],
+                            0x2D9D, Dog_Crouch_rows, Dog_Crouch_spans },
+    [SPRITE_CAT] = { "Cat", CAT_WIDTH, CAT_HEIGHT, &Cat[0][0],
+                     0x2D9D, Cat_rows, Cat_spans },
+    [SPRITE_MUSHROOM] = { "Mushroom", MUSHROOM_WIDTH, MUSHROOM_HEIGHT, &Mushroom[0][0],
+                          0x2D9D, Mushroom_rows, Mushroom_spans },
+    [SPRITE_CRYSTAL] = { "Crystal", CRYSTAL_WIDTH, CRYSTAL_HEIGHT, &Crystal[0][0],
+                         0x2D9D, Crystal_rows, Crystal_spans },
+    [SPRITE_GRASS] = { "Grass", GRASS_WIDTH, GRASS_HEIGHT, &Grass[0][0], -1, NULL, NULL },
+    [SPRITE_POND] = { "Pond", POND_WIDTH, POND_HEIGHT, &Pond[0][0], -1, NULL, NULL },
+};
+
+static int run_text_command(char *command);
+static int run_batch(const u16 *words, int count);
+static void account_command(int op, u64 start_ns, u64 start_pixels);
+
+// Function to run the commands from one write, a binary batch if it starts
+// with the magic word, otherwise a single text command
+int run_commands(char *command, int length)
+{
+    if (length >= 2 && *(u16 *)command == VIDEO_BATCH_MAGIC)
+        return run_batch((const u16 *)command, length / 2);
+    return run_text_command(command);
+}
+
+// Function to run a single text command, e.g., "box 10,10 20,20 0xF800"
+static int run_text_command(char *command) {
+    int x, y, x0, y0, x1, y1, num, id, op, result;
+    short int color;
+    char text[256];
+    char name[32];
+    u64 start_ns, start_pixels;
+
+    // Everything below draws into the back buffer, so wait until there is one
+    result = wait_for_back_buffer();
+    if (result < 0)
+        return result;
+    start_ns = draw_now_ns();
+    start_pixels = pixels_written;
+
+    // Clear screen command
+    if (strncmp(command, "clear", 5) == 0) {
+        op = VIDEO_OP_CLEAR;
+        clear_screen();
+    }
+    // Clear only what was drawn into this buffer last time
+    else if (strncmp(command, "restore", 7) == 0) {
+        op = VIDEO_OP_RESTORE;
+        restore_screen();
+    }
+    // Keep the back buffer as the background that restore goes back to
+    else if (strncmp(command, "savebg", 6) == 0) {
+        op = VIDEO_OP_SAVE_BACKGROUND;
+        save_background();
+    }
+    // Command to draw a sprite by name, e.g., "DogRun1 20,188"
+    else if (sscanf(command, "%31s %d,%d", name, &x, &y) == 3 && (id = find_sprite(name)) >= 0) {
+        op = VIDEO_OP_SPRITE;
+        draw_sprite(id, x, y);
+    }
+    // Clear character buffer command
+    else if (strncmp(command, "erase", 5) == 0) {
+        op = VIDEO_OP_ERASE;
+        erase();
+    }
+    // Command to draw a single pixel, e.g., "pixel 100,100 0x07E0"
+    else if (sscanf(command, "pixel %d,%d %hx", &x, &y, &color) == 3) {
+        op = VIDEO_OP_PIXEL;
+        mark_dirty(x, y, x, y);
+        plot_pixel(x, y, color);
+    }
+    // Command to draw a line, e.g., "line 0,0 100,100 0xFFFF"
+    else if (sscanf(command, "line %d,%d %d,%d %hx", &x0, &y0, &x1, &y1, &color) == 5) {
+        op = VIDEO_OP_LINE;
+        draw_line(x0, y0, x1, y1, color);
+    }
+    // Command to draw a box, e.g., "box 10,10 20,20 0xF800"
+    else if (sscanf(command, "box %d,%d %d,%d %hx", &x0, &y0, &x1, &y1, &color) == 5) {
+        op = VIDEO_OP_BOX;
+        draw_box(x0, y0, x1, y1, color);
+    }
+    // Command to write text, e.g., "text 10,10 Hello World"
+    else if (sscanf(command, "text %d,%d %n", &x, &y, &num) == 2) {
+        op = VIDEO_OP_TEXT;
+        strncpy(text, command + num, sizeof(text) - 1);
+        text[sizeof(text) - 1] = '\0';
+        write_string(x, y, text);
+    }
+    else if(strncmp(command, "TopBackground", 13) == 0) {
+        op = VIDEO_OP_TOP_BACKGROUND;
+        draw_TopBackground();
+    }
+    // Sync command, the swap completes in the background
+    else if (strncmp(command, "sync", 4) == 0) {
+        op = VIDEO_OP_SYNC;
+        result = request_flip();
+        if (result < 0)
+            return result;
+    }
+    // Handle invalid commands
+    else {
+        invalid_commands++;
+        draw_warn("Invalid command: %s\n", command);
+        return -EINVAL;
+    }
+
+    account_command(op, start_ns, start_pixels);
+    return 0;
+}
+
+// Function to run a binary batch of commands (see video.h for the format)
+static int run_batch(const u16 *words, int count) {
+    int i = 1;  // Skip the magic word
+    int op, nargs, len, result;
+    const s16 *args;
+    char text[VIDEO_TEXT_MAX + 1];
+    u64 start_ns, start_pixels;
+
+    while (i < count) {
+        op = VIDEO_CMD_OP(words[i]);
+        nargs = VIDEO_CMD_NARGS(words[i]);
+        args = (const s16 *)&words[i + 1];
+        if (i + 1 + nargs > count)
+            goto invalid;
+
+        // Commands after a sync in the same batch draw into the next back buffer
+        result = wait_for_back_buffer();
+        if (result < 0)
+            return result;
+        start_ns = draw_now_ns();
+        start_pixels = pixels_written;
+
+        switch (op) {
+        case VIDEO_OP_CLEAR:
+            clear_screen();
+            break;
+        case VIDEO_OP_RESTORE:
+            restore_screen();
+            break;
+        case VIDEO_OP_SAVE_BACKGROUND:
+            save_background();
+            break;
+        case VIDEO_OP_SPRITE:
+            if (nargs != 3 || args[0] < 0 || args[0] >= NUM_SPRITES)
+                goto invalid;
+            draw_sprite(args[0], args[1], args[2]);
+            break;
+        case VIDEO_OP_PIXEL:
+            if (nargs != 3)
+                goto invalid;
+            mark_dirty(args[0], args[1], args[0], args[1]);
+            plot_pixel(args[0], args[1], args[2]);
+            break;
+        case VIDEO_OP_LINE:
+            if (nargs != 5)
+                goto invalid;
+            draw_line(args[0], args[1], args[2], args[3], args[4]);
+            break;
+        case VIDEO_OP_BOX:
+            if (nargs != 5)
+                goto invalid;
+            draw_box(args[0], args[1], args[2], args[3], args[4]);
+            break;
+        case VIDEO_OP_TEXT:
+            // Characters are packed two per word after x, y and the length
+            len = (nargs >= 3) ? args[2] : -1;
+            if (len < 0 || len > VIDEO_TEXT_MAX || nargs != 3 + (len + 1) / 2)
+                goto invalid;
+            memcpy(text, &args[3], len);
+            text[len] = '\0';
+            write_string(args[0], args[1], text);
+            break;
+        case VIDEO_OP_ERASE:
+            erase();
+            break;
+        case VIDEO_OP_TOP_BACKGROUND:
+            draw_TopBackground();
+            break;
+        case VIDEO_OP_SYNC:
+            result = request_flip();
+            if (result < 0)
+                return result;
+            break;
+        default:
+            goto invalid;
+        }
+        account_command(op, start_ns, start_pixels);
+        i += 1 + nargs;
+    }
+    return 0;
+
+invalid:
+    invalid_commands++;
+    draw_warn("Invalid batch command 0x%04x at word %d\n", words[i], i);
+    return -EINVAL;
+}
+
+// Function to charge the time and pixels since start_ns/start_pixels to a command
+static void account_command(int op, u64 start_ns, u64 start_pixels)
+{
+    cmd_stats[op].calls++;
+    cmd_stats[op].pixels += pixels_written - start_pixels;
+    cmd_stats[op].ns += draw_now_ns() - start_ns;
+}
+
+// Function to clear the screen (set all pixels to black)
+void clear_screen(void)
+{
+    fill_rect(0, TOP_CUTOFF, resolution_x - 1, resolution_y - 1, BACKGROUND_COLOR); // Light blue
+    dirty[back_buffer].count = 0;
+    dirty[back_buffer].full = background_valid;  // No longer matches a saved background
+}
+
+// Function to clear only the regions drawn into the back buffer since its last clear
+void restore_screen(void)
+{
+    struct dirty_list *list = &dirty[back_buffer];
+    struct dirty_rect *r;
+    int i, y;
+
+    if (list->full) {
+        if (background_valid)
+            restore_background();
+        else
+            clear_screen();
+        return;
+    }
+
+    for (i = 0; i < list->count; i++) {
+        r = &list->rects[i];
+        if (background_valid) {
+            for (y = r->y0; y <= r->y1; y++)
+                copy_row(r->x0, y, background + (y << 9) + r->x0, r->x1 - r->x0 + 1);
+        }
+        else {
+            fill_rect(r->x0, max(r->y0, TOP_CUTOFF), r->x1, r->y1, BACKGROUND_COLOR);
+        }
+    }
+    list->count = 0;
+}
+
+// Function to save the back buffer as the background. The other buffers are
+// brought up to date by their next restore.
+void save_background(void)
+{
+    int i;
+
+    copy_to_background();
+    background_valid = 1;
+    for (i = 0; i < VIDEO_MAX_BUFFERS; i++) {
+        dirty[i].count = 0;
+        dirty[i].full = (i != back_buffer);
+    }
+}
+
+// Function to restore the whole back buffer from the background cache
+void restore_background(void)
+{
+    int y;
+
+    if (copy_from_background() < 0) {
+        for (y = 0; y < resolution_y; y++)
+            copy_row(0, y, background + (y << 9), resolution_x);
+    }
+    dirty[back_buffer].count = 0;
+    dirty[back_buffer].full = 0;
+}
+
+// Function to record a drawn region of the back buffer for the next restore
+void mark_dirty(int x0, int y0, int x1, int y1)
+{
+    struct dirty_list *list = &dirty[back_buffer];
+    struct dirty_rect *r;
+    int i, ux0, uy0, ux1, uy1;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= resolution_x) x1 = resolution_x - 1;
+    if (y1 >= resolution_y) y1 = resolution_y - 1;
+    if (list->full || x0 > x1 || y0 > y1)
+        return;
+
+    // Grow an existing rect when the union covers no more than the two rects
+    // would separately, e.g. the grass tiles along the ground
+    for (i = 0; i < list->count; i++) {
+        r = &list->rects[i];
+        ux0 = min(r->x0, x0);
+        uy0 = min(r->y0, y0);
+        ux1 = max(r->x1, x1);
+        uy1 = max(r->y1, y1);
+        if ((ux1 - ux0 + 1) * (uy1 - uy0 + 1) <=
+            (r->x1 - r->x0 + 1) * (r->y1 - r->y0 + 1) + (x1 - x0 + 1) * (y1 - y0 + 1)) {
+            r->x0 = ux0;
+            r->y0 = uy0;
+            r->x1 = ux1;
+            r->y1 = uy1;
+            return;
+        }
+    }
+
+    if (list->count == MAX_DIRTY_RECTS) {
+        list->full = 1;
+        return;
+    }
+    list->rects[list->count].x0 = x0;
+    list->rects[list->count].y0 = y0;
+    list->rects[list->count].x1 = x1;
+    list->rects[list->count].y1 = y1;
+    list->count++;
+}
+
+// Function to plot a pixel at (x, y) with color
+void plot_pixel(int x, int y, short int color)
+{
+    volatile short int *pixel_address;
+    if (x < 0 || x >= resolution_x || y < 0 || y >= resolution_y)
+        return;
+    pixel_address = (volatile short int *)PIXEL_ADDRESS(x, y);
+    *pixel_address = color;
+    pixels_written++;
+}
+
+// Function to fill len pixels starting at dst using aligned 32-bit stores
+static void fill_span(volatile u16 *dst, u32 pattern, int len)
+{
+    volatile u32 *dst32;
+
+    if (len > 0 && ((unsigned long)dst & 2)) {
+        *dst++ = pattern;
+        len--;
+    }
+    dst32 = (volatile u32 *)dst;
+    for (; len >= 4; len -= 4) {
+        dst32[0] = pattern;
+        dst32[1] = pattern;
+        dst32 += 2;
+    }
+    if (len >= 2) {
+        *dst32++ = pattern;
+        len -= 2;
+    }
+    if (len > 0)
+        *(volatile u16 *)dst32 = pattern;
+}
+
+#ifdef CONFIG_KERNEL_MODE_NEON
+// Function to fill 16 * blocks pixels at a word aligned dst with NEON stores,
+// 32 bytes per store. Must be called between kernel_neon_begin/end, which save
+// the NEON registers, so they are not listed as clobbered.
+static void fill_blocks_neon(volatile u16 *dst, u32 pattern, int blocks)
+{
+    asm volatile(
+        "vdup.32 q0, %[pattern]\n"
+        "vmov q1, q0\n"
+        "1: vst1.32 {d0-d3}, [%[dst]]!\n"
+        "subs %[blocks], %[blocks], #1\n"
+        "bne 1b\n"
+        : [dst] "+r" (dst), [blocks] "+r" (blocks)
+        : [pattern] "r" (pattern)
+        : "cc", "memory");
+}
+#endif
+
+// Function to fill a rectangle (inclusive corners, clipped to the screen) a row at a time
+void fill_rect(int x0, int y0, int x1, int y1, short int color)
+{
+    u32 pattern = (u16)color | ((u32)(u16)color << 16);
+    int y, width;
+#ifdef CONFIG_KERNEL_MODE_NEON
+    volatile u16 *dst;
+    int head, blocks;
+#endif
+
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, resolution_x - 1);
+    y1 = min(y1, resolution_y - 1);
+    width = x1 - x0 + 1;
+    if (width <= 0 || y0 > y1)
+        return;
+    pixels_written += width * (y1 - y0 + 1);
+
+#ifdef CONFIG_KERNEL_MODE_NEON
+    if (width >= NEON_MIN_PIXELS && cpu_has_neon()) {
+        kernel_neon_begin();
+        for (y = y0; y <= y1; y++) {
+            dst = (volatile u16 *)PIXEL_ADDRESS(x0, y);
+            head = (x0 & 1);    // Rows are word aligned, so only odd x needs a lead-in
+            fill_span(dst, pattern, head);
+            blocks = (width - head) / 16;
+            if (blocks)
+                fill_blocks_neon(dst + head, pattern, blocks);
+            fill_span(dst + head + blocks * 16, pattern, width - head - blocks * 16);
+        }
+        kernel_neon_end();
+        return;
+    }
+#endif
+
+    for (y = y0; y <= y1; y++)
+        fill_span((volatile u16 *)PIXEL_ADDRESS(x0, y), pattern, width);
+}
+
+// Function to copy len pixels from src to the back buffer starting at (x, y).
+// In the driver memcpy_toio() is the ARM word/burst copy, so this writes whole words
+// wherever source and destination alignment allow.
+void copy_row(int x, int y, const unsigned short *src, int len)
+{
+    copy_to_pixels(PIXEL_ADDRESS(x, y), src, len << 1);
+    pixels_written += len;
+}
+
+void draw_line(int x0, int y0, int x1, int y1, short int color)
+{
+    int deltax, deltay, error, y, y_step;
+    int is_steep = (abs(y1 - y0) > abs(x1 - x0));
+
+    mark_dirty(min(x0, x1), min(y0, y1), max(x0, x1), max(y0, y1));
+    if (is_steep) {
+        // Swap x and y coordinates if the line is steep
+        int temp = x0; x0 = y0; y0 = temp;
+        temp = x1; x1 = y1; y1 = temp;
+    }
+
+    if (x0 > x1) {
+        // Swap start and end points if x0 > x1
+        int temp = x0; x0 = x1; x1 = temp;
+        temp = y0; y0 = y1; y1 = temp;
+    }
+
+    deltax = (x1 - x0);
+    deltay = abs(y1 - y0);
+    error = -(deltax / 2);
+    y = y0;
+    y_step = (y0 < y1) ? 1 : -1;
+
+  
+
+    for (; x0 <= x1; x0++) {
+        if (is_steep) {
+            plot_pixel(y, x0, color);  // Plot the pixel with swapped coordinates
+        } else {
+            plot_pixel(x0, y, color);
+        }
+        error += deltay;
+        if (error >= 0) {
+            y += y_step;
+            error -= deltax;
+        }
+    }
+}
+
+void draw_box(int x0, int y0, int x1, int y1, short int color)
+{
+    mark_dirty(x0, y0, x1, y1);
+    // Fill the rectangle's area with the specified color
+    fill_rect(x0, y0, x1, y1, color);
+}
+
+// Function to write a character to the character buffer
+void write_char(int x, int y, char c) {
+    if (x < 0 || x >= char_resolution_x || y < 0 || y >= char_resolution_y)
+        return;
+    *(volatile char *)(character_buffer + (y << 7) + x) = c;
+    pixels_written++;
+}
+
+// Function to write a string starting at (x, y)
+void write_string(int x, int y, const char *str) {
+    while (*str) {
+        write_char(x++, y, *str++);
+        if (x >= char_resolution_x) {
+            x = 0;
+            y++;
+            if (y >= char_resolution_y)
+                break;
+        }
+    }
+}
+
+// Function to erase all text on the screen
+void erase()
+{
+    int x, y;
+    for (y = 0; y < 60; y++) {  // Adjust to character grid resolution
+        for (x = 0; x < 80; x++) {
+            volatile short int *character_address = (volatile short int *)(character_buffer + (y << 7) + x);
+            *character_address = (int)' ';  // Clear the character buffer by setting to a blank space
+        }
+    }
+    pixels_written += 80 * 60;
+}
+
+// Function to get the name text commands use for a sprite id
+const char *sprite_name(int id)
+{
+    return sprites[id].name;
+}
+
+// Function to look up a sprite id by the name used in text commands
+int find_sprite(const char *name)
+{
+    int id;
+    for (id = 0; id < NUM_SPRITES; id++) {
+        if (strcmp(sprites[id].name, name) == 0)
+            return id;
+    }
+    return -1;
+}
+
+// Function to draw a sprite with its top-left corner at (x, y). The sprite is
+// clipped to the screen below the sky, and the visible rows and columns are
+// worked out once so the copy loops need no bounds checks.
+void draw_sprite(int id, int x, int y)
+{
+    const struct sprite *sp = &sprites[id];
+    const unsigned short *src;
+    int i, j, k, sx, ex;
+    int col0 = max(0, -x);
+    int col1 = min(sp->width, resolution_x - x);
+    int row0 = max(0, TOP_CUTOFF - y);
+    int row1 = min(sp->height, resolution_y - y);
+
+    if (col0 >= col1 || row0 >= row1)
+        return;
+    mark_dirty(x + col0, y + row0, x + col1 - 1, y + row1 - 1);
+
+    for (i = row0; i < row1; ++i) {
+        src = sp->data + i * sp->width;
+        if (sp->spans) {
+            // Copy each opaque run in one go, transparent pixels are never touched
+            for (k = sp->rows[i]; k < sp->rows[i + 1]; ++k) {
+                sx = max((int)sp->spans[k].x, col0);
+                ex = min(sp->spans[k].x + sp->spans[k].len, col1);
+                if (sx < ex)
+                    copy_row(x + sx, y + i, src + sx, ex - sx);
+            }
+        }
+        else if (sp->key < 0) {
+            copy_row(x + col0, y + i, src + col0, col1 - col0);
+        }
+        else {
+            for (j = col0; j < col1; ++j) {
+                if (src[j] != sp->key)
+                    plot_pixel(x + j, y + i, src[j]);
+            }
+        }
+    }
+}
+
+void draw_TopBackground(){
+    int i;
+    // Copy the sky a whole row at a time
+    for (i = 0; i < TOP_CUTOFF; ++i) {
+        copy_row(0, i, TopBackground[i], TOPBACKGROUND_WIDTH);
+    }
+}
@@ -0,0 +1,106 @@
+// videoDraw.h
+// Drawing core shared by the /dev/video driver (videoDriver.c) and the
+// user-space simulator (videoSim.c). The core draws into whatever
+// pixel_buffer and character_buffer point at; the backend owns the buffers,
+// the background cache and buffer swaps, and provides the functions at the
+// end of this file.
+#ifndef VIDEO_DRAW_H
+#define VIDEO_DRAW_H
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#include <linux/string.h>
+#include <linux/io.h>
+#define draw_warn(...) printk(KERN_WARNING __VA_ARGS__)
+#define copy_to_pixels(dst, src, n) memcpy_toio((void __iomem *)(dst), src, n)
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+typedef uint16_t u16;
+typedef int16_t s16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define draw_warn(...) fprintf(stderr, __VA_ARGS__)
+#define copy_to_pixels(dst, src, n) memcpy((void *)(dst), src, n)
+#endif
+#include "video.h"
+
+#define TOP_CUTOFF 60
+#define BACKGROUND_COLOR 0x2D9D
+#define MAX_DIRTY_RECTS 32
+
+// Address of pixel (x, y) in the current back buffer
+#define PIXEL_ADDRESS(x, y) (pixel_buffer + ((y) << 10) + ((x) << 1))
+
+// Regions drawn into a pixel buffer since it was last cleared, so "restore"
+// only has to repaint those instead of the whole screen
+struct dirty_rect {
+    int x0, y0, x1, y1;     // Inclusive corners
+};
+
+struct dirty_list {
+    struct dirty_rect rects[MAX_DIRTY_RECTS];
+    int count;
+    int full;               // Contents unknown or too many rects, clear everything
+};
+
+// Per-command cost, see run_commands()
+struct command_stats {
+    u64 calls;
+    u64 pixels;             // Pixels (characters for text and erase) written
+    u64 ns;                 // Time spent drawing, not counting waits for a buffer
+};
+
+// Drawing state, set up by the backend
+extern unsigned long pixel_buffer, character_buffer;   // Back buffer and character buffer addresses
+extern int resolution_x, resolution_y;                  // VGA screen size
+extern int char_resolution_x, char_resolution_y;
+extern int back_buffer;                                 // Index of pixel_buffer, -1 while none is free
+extern struct dirty_list dirty[VIDEO_MAX_BUFFERS];
+
+// Pre-composited background with the same 1024-byte row layout as a pixel buffer
+extern u16 *background;
+extern int background_valid;
+
+// Statistics kept by run_commands()
+extern struct command_stats cmd_stats[VIDEO_NUM_OPS];
+extern u64 pixels_written;              // Running total bumped by the drawing primitives
+extern u64 invalid_commands;
+extern const char *const op_names[VIDEO_NUM_OPS];
+
+// Commands, as written to /dev/video. command must be NUL terminated at
+// command[length] and 2-byte aligned. Returns 0 or -EINVAL.
+int run_commands(char *command, int length);
+
+// Drawing primitives
+void clear_screen(void);
+void restore_screen(void);
+void save_background(void);
+void restore_background(void);
+void mark_dirty(int x0, int y0, int x1, int y1);
+void plot_pixel(int x, int y, short int color);
+void fill_rect(int x0, int y0, int x1, int y1, short int color);
+void copy_row(int x, int y, const unsigned short *src, int len);
+void draw_line(int x0, int y0, int x1, int y1, short int color);
+void draw_box(int x0, int y0, int x1, int y1, short int color);
+void write_char(int x, int y, char c);
+void write_string(int x, int y, const char *str);
+void erase(void);
+int find_sprite(const char *name);
+const char *sprite_name(int id);
+void draw_sprite(int id, int x, int y);
+void draw_TopBackground(void);
+
+// Provided by the backend
+int wait_for_back_buffer(void);         // Wait until back_buffer >= 0, < 0 on a signal or timeout
+int request_flip(void);                 // Queue the back buffer for display, < 0 as above
+void copy_to_background(void);          // Copy the back buffer into background
+int copy_from_background(void);         // Fast whole-buffer restore, < 0 to copy row by row
+u64 draw_now_ns(void);                  // Monotonic clock for the statistics
+
+#endif // VIDEO_DRAW_H
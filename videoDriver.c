@@ -0,0 +1,735 @@
+// VGA video character driver with clear, pixel, line, sync, box, erase, and text commands. Sync has buffer swap between ONCHIP and SDRAM. Character and pixel writing.
+// The drawing itself lives in videoDraw.c, this file maps the hardware and handles the device.
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/fs.h>
+#include <linux/cdev.h>
+#include <linux/device.h>
+#include <linux/uaccess.h>
+#include <asm/io.h>
+#include <linux/io.h>
+#include <linux/string.h>
+#include <linux/slab.h>
+#include <linux/mutex.h>
+#include <linux/mm.h>
+#include <linux/dmaengine.h>
+#include <linux/dma-mapping.h>
+#include <linux/hrtimer.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/ktime.h>
+#include "address_map_arm.h"
+#include "video.h"
+#include "videoDraw.h"
+
+// Declare global variables needed to use the pixel buffer
+void *LW_virtual, *SDRAM_virtual, *ONCHIP_virtual, *FPGA_CHAR_virtual;                   // used to access FPGA light-weight bridge
+volatile int *pixel_ctrl_ptr;       // virtual address of pixel buffer controller and character buffer
+
+// Physical and virtual addresses of the pixel buffers, indexed like back_buffer
+static const unsigned long buffer_phys[VIDEO_MAX_BUFFERS] = {
+    SDRAM_BASE, FPGA_ONCHIP_BASE, SDRAM_BASE + VIDEO_FRAME_BYTES
+};
+static void *buffer_virtual[VIDEO_MAX_BUFFERS];
+
+// Number of pixel buffers to cycle through, 3 for triple buffering
+static int num_buffers = 2;
+module_param(num_buffers, int, 0444);
+MODULE_PARM_DESC(num_buffers, "Pixel buffers to use: 2 (double) or 3 (triple buffering)");
+
+// The background cache (sky, field and grass) is kept in kernel memory, so
+// restoring it is a plain block copy. The copy is done by the HPS DMA engine
+// when one is available.
+static struct dma_chan *dma_chan;
+static dma_addr_t background_dma;
+
+// Declare variables and prototypes needed for a character device driver
+dev_t dev_num;
+static struct cdev video_cdev;
+static struct class *video_class = NULL;
+static struct task_struct *video_thread;
+
+// Finished frames wait in ready_queue to be shown, oldest first. The head is
+// handed to the controller and flip_timer polls its status register until the
+// swap lands, then starts the next one and wakes flip_wait. front_buffer is
+// the buffer being scanned out. All of these are protected by flip_lock.
+static int front_buffer;
+static int ready_queue[VIDEO_MAX_BUFFERS];
+static int ready_count;
+static int flip_pending;
+static struct hrtimer flip_timer;
+static DECLARE_WAIT_QUEUE_HEAD(flip_wait);
+static DEFINE_SPINLOCK(flip_lock);
+
+// Commands are copied into a static buffer instead of a kmalloc per write
+static char command[VIDEO_BATCH_BYTES + 1] __aligned(4);
+static DEFINE_MUTEX(video_lock);
+
+#define DEVICE_NAME "video"
+#define BUF_SIZE 100
+#define FLIP_POLL_NS 500000     // How often a pending swap is checked for completion
+#define FLIP_WAIT_MS 100        // Longest wait for a free buffer, a few frames, before giving up
+
+// Statistics are read from /sys/kernel/debug/video/stats and reset by writing
+// anything to it. Command counters (kept by videoDraw.c) are updated under
+// video_lock and the swap counters under flip_lock.
+static u64 buffer_waits, buffer_wait_ns; // Commands that had to wait for a free buffer
+static u64 flips, flip_ns;              // Completed swaps, time from start to landing
+static ktime_t flip_started;
+static struct dentry *debugfs_dir;
+
+// Function Prototypes
+
+// Device driver utilities
+static int video_open(struct inode *inode, struct file *file);
+static int video_close(struct inode *inode, struct file *file);
+static ssize_t video_read(struct file *file, char __user *buf, size_t len, loff_t *offset);
+static ssize_t device_write(struct file *filp, const char *buffer, size_t length, loff_t *offset);
+static int video_mmap(struct file *file, struct vm_area_struct *vma);
+static long video_ioctl(struct file *file, unsigned int cmd, unsigned long arg);
+static enum hrtimer_restart flip_timer_callback(struct hrtimer *timer);
+static unsigned int video_poll(struct file *file, poll_table *wait);
+static int stats_open(struct inode *inode, struct file *file);
+static ssize_t stats_write(struct file *file, const char __user *buf, size_t len, loff_t *offset);
+
+// Hardware side of the video driver, the drawing functions are in videoDraw.h
+void get_screen_specs(volatile int *pixel_ctrl_ptr);
+int setup_background(void);
+void free_background(void);
+int sync_with_vga(void);
+static void start_flip(void);
+static int find_free_buffer(void);
+static void publish_back_buffer(int buffer);
+
+// File operations structure
+static struct file_operations fops = {
+    .owner = THIS_MODULE,
+    .open = video_open,
+    .release = video_close,
+    .read = video_read,
+    .write = device_write,
+    .mmap = video_mmap,
+    .unlocked_ioctl = video_ioctl,
+    .poll = video_poll,
+};
+
+// debugfs statistics file
+static const struct file_operations stats_fops = {
+    .owner = THIS_MODULE,
+    .open = stats_open,
+    .read = seq_read,
+    .write = stats_write,
+    .llseek = seq_lseek,
+    .release = single_release,
+};
+
+// Initialize the video driver
+static int __init start_video(void)
+{
+    
+    int result;
+    unsigned long front_phys;
+
+    // Allocate device number
+    result = alloc_chrdev_region(&dev_num, 0, 1, DEVICE_NAME);
+    if (result < 0) {
+        printk(KERN_ERR "Failed to allocate a device number\n");
+        return result;
+    }
+
+    // Initialize the cdev structure and add it to the kernel
+    cdev_init(&video_cdev, &fops);
+    video_cdev.owner = THIS_MODULE;
+    result = cdev_add(&video_cdev, dev_num, 1);
+    if (result < 0) {
+        printk(KERN_ERR "Failed to add cdev\n");
+        goto fail_region;
+    }
+
+    // Create device class
+    video_class = class_create(THIS_MODULE, DEVICE_NAME);
+    if (IS_ERR(video_class)) {
+        printk(KERN_ERR "Failed to create class\n");
+        result = PTR_ERR(video_class);
+        goto fail_cdev;
+    }
+
+    // Create device
+    if (device_create(video_class, NULL, dev_num, NULL, DEVICE_NAME) == NULL) {
+        printk(KERN_ERR "Failed to create device\n");
+        result = -1;
+        goto fail_class;
+    }
+
+    // Map FPGA lightweight bridge
+    LW_virtual = ioremap_nocache(LW_BRIDGE_BASE, LW_BRIDGE_SPAN);
+    if (LW_virtual == NULL) {
+        printk(KERN_ERR "Error: ioremap_nocache returned NULL for LW buffer\n");
+        result = -ENOMEM;
+        goto fail_device;
+    }
+
+    // Map SDRAM
+    SDRAM_virtual = ioremap_nocache(SDRAM_BASE, SDRAM_SPAN);
+    if (SDRAM_virtual == NULL) {
+        printk(KERN_ERR "Error: ioremap_nocache returned NULL for SDRAM buffer\n");
+        result = -ENOMEM;
+        goto fail_lw;
+    }
+
+    // Map ONCHIP pixel buffer
+    ONCHIP_virtual = ioremap_nocache(FPGA_ONCHIP_BASE, FPGA_ONCHIP_SPAN);
+    if (ONCHIP_virtual == NULL) {
+        printk(KERN_ERR "Error: ioremap_nocache returned NULL for ONCHIP buffer\n");
+        result = -ENOMEM;
+        goto fail_sdram;
+    }
+
+    // Map character buffer
+    FPGA_CHAR_virtual = ioremap_nocache(FPGA_CHAR_BASE, FPGA_CHAR_SPAN);
+    if (FPGA_CHAR_virtual == NULL) {
+        printk(KERN_ERR "Error: ioremap_nocache returned NULL for CHARACTER buffer\n");
+        result = -ENOMEM;
+        goto fail_onchip;
+    }
+
+   
+
+    // Create virtual memory access to the pixel buffer controller
+    pixel_ctrl_ptr = (volatile int *)(LW_virtual + PIXEL_BUF_CTRL_BASE);
+    get_screen_specs(pixel_ctrl_ptr);
+
+    // Create virtual memory access to the pixel buffers, the third one sits
+    // right after the first in SDRAM
+    buffer_virtual[VIDEO_BUF_SDRAM] = SDRAM_virtual;
+    buffer_virtual[VIDEO_BUF_ONCHIP] = ONCHIP_virtual;
+    buffer_virtual[VIDEO_BUF_SDRAM2] = SDRAM_virtual + VIDEO_FRAME_BYTES;
+    if (num_buffers < 2 || num_buffers > VIDEO_MAX_BUFFERS) {
+        printk(KERN_WARNING "Unsupported num_buffers %d, using 2\n", num_buffers);
+        num_buffers = 2;
+    }
+
+    // Start drawing into whichever buffer is not on screen, any of the
+    // three may be showing after an earlier load
+    front_phys = *pixel_ctrl_ptr;
+    front_buffer = VIDEO_BUF_ONCHIP;
+    for (result = 0; result < VIDEO_MAX_BUFFERS; result++)
+        if (front_phys == buffer_phys[result])
+            front_buffer = result;
+    back_buffer = find_free_buffer();
+    pixel_buffer = (unsigned long)buffer_virtual[back_buffer];
+
+    // Create virtual memory access to the character buffer
+    character_buffer = (unsigned long)FPGA_CHAR_virtual;
+    if (character_buffer == 0) {
+        printk(KERN_ERR "Error: ioremap_nocache returned NULL for CHAR BUFFER\n");
+        result = -ENOMEM;
+        goto fail_onchip;
+    }
+
+    hrtimer_init(&flip_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+    flip_timer.function = flip_timer_callback;
+
+    // Allocate the background cache and look for a DMA engine to restore it with
+    result = setup_background();
+    if (result < 0)
+        goto fail_char;
+
+    // Nothing is known about either buffer until it has been cleared
+    for (result = 0; result < VIDEO_MAX_BUFFERS; result++)
+        dirty[result].full = 1;
+
+    // Erase the pixel buffer
+    clear_screen();
+
+    // Statistics are a debugging aid, so the driver works without them
+    debugfs_dir = debugfs_create_dir(DEVICE_NAME, NULL);
+    if (!IS_ERR_OR_NULL(debugfs_dir))
+        debugfs_create_file("stats", 0644, debugfs_dir, NULL, &stats_fops);
+    
+    printk(KERN_INFO "Video driver started successfully\n");
+    return 0;
+
+    // Undo whatever was set up before the failure, in reverse order
+fail_char:
+    iounmap(FPGA_CHAR_virtual);
+fail_onchip:
+    iounmap(ONCHIP_virtual);
+fail_sdram:
+    iounmap(SDRAM_virtual);
+fail_lw:
+    iounmap(LW_virtual);
+fail_device:
+    device_destroy(video_class, dev_num);
+fail_class:
+    class_destroy(video_class);
+fail_cdev:
+    cdev_del(&video_cdev);
+fail_region:
+    unregister_chrdev_region(dev_num, 1);
+    return result;
+}
+
+// Exit the video driver
+static void __exit stop_video(void)
+{
+    debugfs_remove_recursive(debugfs_dir);
+    wait_event(flip_wait, READ_ONCE(ready_count) == 0);
+    hrtimer_cancel(&flip_timer);
+    if (wait_for_back_buffer() == 0)
+        clear_screen();
+    free_background();
+
+    // Unmap the virtual addresses
+    iounmap(LW_virtual);
+    iounmap(SDRAM_virtual);
+    iounmap(ONCHIP_virtual);
+    iounmap(FPGA_CHAR_virtual);
+
+    // Destroy device and class
+    device_destroy(video_class, dev_num);
+    class_destroy(video_class);
+
+    // Delete cdev and unregister device number
+    cdev_del(&video_cdev);
+    unregister_chrdev_region(dev_num, 1);
+
+    printk(KERN_INFO "Video driver removed\n");
+}
+
+// Function to synchronize with VGA controller, waiting until there is a buffer to draw into
+int sync_with_vga(void)
+{
+    int result = request_flip();
+
+    if (result < 0)
+        return result;
+    return wait_for_back_buffer();
+}
+
+// Function to queue the back buffer for display without waiting for it to be shown
+int request_flip(void)
+{
+    unsigned long flags;
+    int result;
+
+    result = wait_for_back_buffer();
+    if (result < 0)
+        return result;
+    wmb();                // Make sure all drawing has landed before the swap
+
+    spin_lock_irqsave(&flip_lock, flags);
+    ready_queue[ready_count++] = back_buffer;
+    if (!flip_pending)
+        start_flip();
+
+    // Carry on in a free buffer if there is one, otherwise wait for the
+    // flip_timer to hand one back
+    publish_back_buffer(find_free_buffer());
+    spin_unlock_irqrestore(&flip_lock, flags);
+    return 0;
+}
+
+// Function to make buffer the back buffer. back_buffer is read without
+// flip_lock, so pixel_buffer has to be visible before it is: a reader that
+// sees the new back_buffer after smp_rmb() also sees the matching
+// pixel_buffer. Called with flip_lock held.
+static void publish_back_buffer(int buffer)
+{
+    if (buffer >= 0) {
+        pixel_buffer = (unsigned long)buffer_virtual[buffer];
+        smp_wmb();
+    }
+    WRITE_ONCE(back_buffer, buffer);
+}
+
+// Function to wait until there is a buffer that is neither on screen nor
+// waiting to be shown, which then becomes the back buffer. Returns
+// -ERESTARTSYS if a signal arrives and -ETIMEDOUT if the controller has not
+// finished a swap within FLIP_WAIT_MS, so a stuck controller cannot leave the
+// caller unkillable.
+int wait_for_back_buffer(void)
+{
+    u64 start;
+    long left;
+
+    if (READ_ONCE(back_buffer) >= 0) {
+        smp_rmb();            // Pairs with publish_back_buffer(), so pixel_buffer matches
+        return 0;
+    }
+    start = ktime_get_ns();
+    left = wait_event_interruptible_timeout(flip_wait, READ_ONCE(back_buffer) >= 0,
+                                            msecs_to_jiffies(FLIP_WAIT_MS));
+    if (left < 0)
+        return left;
+    if (left == 0)
+        return -ETIMEDOUT;
+    smp_rmb();
+    buffer_waits++;
+    buffer_wait_ns += ktime_get_ns() - start;
+    return 0;
+}
+
+// Function to find a buffer that is neither on screen nor queued, -1 if none.
+// Called with flip_lock held.
+static int find_free_buffer(void)
+{
+    int i, k, used;
+
+    for (i = 0; i < num_buffers; i++) {
+        used = (i == front_buffer);
+        for (k = 0; k < ready_count; k++)
+            used |= (ready_queue[k] == i);
+        if (!used)
+            return i;
+    }
+    return -1;
+}
+
+// Function to hand the oldest finished frame to the controller. Called with flip_lock held.
+static void start_flip(void)
+{
+    *(pixel_ctrl_ptr + 1) = buffer_phys[ready_queue[0]];  // Backbuffer register
+    *pixel_ctrl_ptr = 1;  // Write 1 to the Buffer register to start a swap
+    flip_pending = 1;
+    flip_started = ktime_get();
+    hrtimer_start(&flip_timer, ns_to_ktime(FLIP_POLL_NS), HRTIMER_MODE_REL);
+}
+
+// Timer callback that completes a swap once the S bit in the Status register
+// clears, then starts the next queued frame, if any
+static enum hrtimer_restart flip_timer_callback(struct hrtimer *timer)
+{
+    int i, restart = 0;
+
+    if (*(pixel_ctrl_ptr + 3) & 0x01) {
+        hrtimer_forward_now(timer, ns_to_ktime(FLIP_POLL_NS));
+        return HRTIMER_RESTART;
+    }
+
+    spin_lock(&flip_lock);
+    flips++;
+    flip_ns += ktime_to_ns(ktime_sub(ktime_get(), flip_started));
+    front_buffer = ready_queue[0];
+    for (i = 1; i < ready_count; i++)
+        ready_queue[i - 1] = ready_queue[i];
+    ready_count--;
+    flip_pending = 0;
+
+    // The buffer that just left the screen is free again
+    if (back_buffer < 0)
+        publish_back_buffer(find_free_buffer());
+
+    if (ready_count > 0) {
+        *(pixel_ctrl_ptr + 1) = buffer_phys[ready_queue[0]];
+        *pixel_ctrl_ptr = 1;
+        flip_pending = 1;
+        flip_started = ktime_get();
+        hrtimer_forward_now(timer, ns_to_ktime(FLIP_POLL_NS));
+        restart = 1;
+    }
+    spin_unlock(&flip_lock);
+
+    wake_up(&flip_wait);
+    return restart ? HRTIMER_RESTART : HRTIMER_NORESTART;
+}
+
+// Function to open the device
+static int video_open(struct inode *inode, struct file *file)
+{
+    printk(KERN_INFO "Video driver opened\n");
+    return 0;
+}
+
+// Function to close the device
+static int video_close(struct inode *inode, struct file *file)
+{
+    printk(KERN_INFO "Video driver closed\n");
+    return 0;
+}
+
+// Function to read from the device
+static ssize_t video_read(struct file *file, char __user *buf, size_t len, loff_t *offset)
+{
+    char buffer[BUF_SIZE];
+    int bytes_read;
+
+    snprintf(buffer, BUF_SIZE, "%d %d\n", resolution_x, resolution_y);
+    bytes_read = strlen(buffer) + 1;
+
+    if (*offset >= bytes_read)
+        return 0;
+
+    if (len > bytes_read - *offset)
+        len = bytes_read - *offset;
+
+    if (copy_to_user(buf, buffer + *offset, len))
+        return -EFAULT;
+
+    *offset += len;
+    return len;
+}
+
+// Function to map the pixel buffers into user space, in video_buffer order
+static int video_mmap(struct file *file, struct vm_area_struct *vma)
+{
+    unsigned long size = vma->vm_end - vma->vm_start;
+    unsigned long offset, len;
+    int i;
+
+    if (vma->vm_pgoff != 0 || size > VIDEO_MAX_BUFFERS * VIDEO_FRAME_BYTES)
+        return -EINVAL;
+
+    // User space can now draw anywhere, so the next restore has to clear everything
+    mutex_lock(&video_lock);
+    for (i = 0; i < VIDEO_MAX_BUFFERS; i++)
+        dirty[i].full = 1;
+    mutex_unlock(&video_lock);
+
+    // Uncached but write-combined, so sprite rows go out as bursts
+    vma->vm_page_prot = pgprot_writecombine(vma->vm_page_prot);
+    for (i = 0; i < VIDEO_MAX_BUFFERS; i++) {
+        offset = i * VIDEO_FRAME_BYTES;
+        if (offset >= size)
+            break;
+        len = min(size - offset, (unsigned long)VIDEO_FRAME_BYTES);
+        if (io_remap_pfn_range(vma, vma->vm_start + offset, buffer_phys[i] >> PAGE_SHIFT,
+                               len, vma->vm_page_prot))
+            return -EAGAIN;
+    }
+    return 0;
+}
+
+// Function to swap buffers or query the back buffer for user space rendering
+static long video_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    int buffer, result;
+
+    if (READ_ONCE(back_buffer) < 0 && (file->f_flags & O_NONBLOCK))
+        return -EAGAIN;
+    smp_rmb();
+
+    mutex_lock(&video_lock);
+    switch (cmd) {
+    case VIDEO_IOC_FLIP:
+        result = request_flip();
+        mutex_unlock(&video_lock);
+        return result;
+    case VIDEO_IOC_SYNC:
+        result = sync_with_vga();
+        buffer = READ_ONCE(back_buffer);
+        break;
+    case VIDEO_IOC_GET_BACK:
+        result = wait_for_back_buffer();
+        buffer = READ_ONCE(back_buffer);
+        break;
+    default:
+        mutex_unlock(&video_lock);
+        return -ENOTTY;
+    }
+    mutex_unlock(&video_lock);
+
+    if (result < 0)
+        return result;
+
+    if (put_user(buffer, (int __user *)arg))
+        return -EFAULT;
+    return 0;
+}
+
+// Function to report whether the back buffer can be drawn into (no swap pending)
+static unsigned int video_poll(struct file *file, poll_table *wait)
+{
+    unsigned int mask = POLLIN | POLLRDNORM;
+
+    poll_wait(file, &flip_wait, wait);
+    if (READ_ONCE(back_buffer) >= 0) {
+        smp_rmb();
+        mask |= POLLOUT | POLLWRNORM;
+    }
+    return mask;
+}
+
+// Function to write to the device
+static ssize_t device_write(struct file *filp, const char *buffer, size_t length, loff_t *offset) {
+    int result;
+
+    if (length > VIDEO_BATCH_BYTES)
+        return -EINVAL;
+
+    // Drawing has to wait for a free buffer, unless the caller would rather not
+    if (READ_ONCE(back_buffer) < 0 && (filp->f_flags & O_NONBLOCK))
+        return -EAGAIN;
+    smp_rmb();
+
+    mutex_lock(&video_lock);
+    if (copy_from_user(command, buffer, length)) {
+        mutex_unlock(&video_lock);
+        return -EFAULT;
+    }
+    command[length] = '\0';
+
+    result = run_commands(command, length);
+    mutex_unlock(&video_lock);
+
+    if (result < 0)
+        return result;
+    return length;
+}
+
+// Function to print the statistics as a table, one row per command
+static int stats_show(struct seq_file *m, void *v)
+{
+    unsigned long flags;
+    u64 n_flips, n_flip_ns;
+    int op;
+
+    spin_lock_irqsave(&flip_lock, flags);
+    n_flips = flips;
+    n_flip_ns = flip_ns;
+    spin_unlock_irqrestore(&flip_lock, flags);
+
+    mutex_lock(&video_lock);
+    seq_printf(m, "%-14s %10s %14s %14s\n", "command", "calls", "pixels", "ns");
+    for (op = VIDEO_OP_CLEAR; op < VIDEO_NUM_OPS; op++)
+        seq_printf(m, "%-14s %10llu %14llu %14llu\n", op_names[op],
+                   cmd_stats[op].calls, cmd_stats[op].pixels, cmd_stats[op].ns);
+    seq_printf(m, "invalid_commands %llu\n", invalid_commands);
+    seq_printf(m, "buffer_waits %llu\n", buffer_waits);
+    seq_printf(m, "buffer_wait_ns %llu\n", buffer_wait_ns);
+    mutex_unlock(&video_lock);
+    seq_printf(m, "flips %llu\n", n_flips);
+    seq_printf(m, "flip_ns %llu\n", n_flip_ns);
+    return 0;
+}
+
+static int stats_open(struct inode *inode, struct file *file)
+{
+    return single_open(file, stats_show, NULL);
+}
+
+// Function to reset the statistics, whatever is written
+static ssize_t stats_write(struct file *file, const char __user *buf, size_t len, loff_t *offset)
+{
+    unsigned long flags;
+
+    mutex_lock(&video_lock);
+    memset(cmd_stats, 0, sizeof(cmd_stats));
+    invalid_commands = 0;
+    buffer_waits = 0;
+    buffer_wait_ns = 0;
+    mutex_unlock(&video_lock);
+
+    spin_lock_irqsave(&flip_lock, flags);
+    flips = 0;
+    flip_ns = 0;
+    spin_unlock_irqrestore(&flip_lock, flags);
+    return len;
+}
+
+// Function to get screen specifications
+void get_screen_specs(volatile int *pixel_ctrl_ptr)
+{
+    int resolution_reg = *(pixel_ctrl_ptr + 2); // Read the Resolution register
+    resolution_x = resolution_reg & 0xFFFF;
+    resolution_y = (resolution_reg >> 16) & 0xFFFF;
+}
+
+// Function to allocate the background cache and map it for the DMA engine, if any
+int setup_background(void)
+{
+    dma_cap_mask_t mask;
+
+    background = (u16 *)__get_free_pages(GFP_KERNEL | __GFP_ZERO, get_order(VIDEO_FRAME_BYTES));
+    if (background == NULL) {
+        printk(KERN_ERR "Error allocating background cache\n");
+        return -ENOMEM;
+    }
+
+    dma_cap_zero(mask);
+    dma_cap_set(DMA_MEMCPY, mask);
+    dma_chan = dma_request_channel(mask, NULL, NULL);
+    if (dma_chan) {
+        background_dma = dma_map_single(dma_chan->device->dev, background, VIDEO_FRAME_BYTES,
+                                        DMA_TO_DEVICE);
+        if (dma_mapping_error(dma_chan->device->dev, background_dma)) {
+            dma_release_channel(dma_chan);
+            dma_chan = NULL;
+        }
+    }
+    printk(KERN_INFO "Video background restore uses %s\n", dma_chan ? "DMA" : "memcpy");
+    return 0;
+}
+
+// Function to release the background cache and DMA channel
+void free_background(void)
+{
+    if (dma_chan) {
+        dma_unmap_single(dma_chan->device->dev, background_dma, VIDEO_FRAME_BYTES, DMA_TO_DEVICE);
+        dma_release_channel(dma_chan);
+        dma_chan = NULL;
+    }
+    free_pages((unsigned long)background, get_order(VIDEO_FRAME_BYTES));
+    background = NULL;
+}
+
+// Function to copy the rows from rows0 up to the bottom of the screen from the
+// background cache with the DMA engine, returns 0 on success
+static int restore_rows_dma(int row0)
+{
+    struct dma_async_tx_descriptor *tx;
+    dma_cookie_t cookie;
+    size_t offset = row0 * VIDEO_ROW_BYTES;
+
+    // No IOMMU on the HPS, so the pixel buffer's physical address is its bus address
+    tx = dmaengine_prep_dma_memcpy(dma_chan, buffer_phys[back_buffer] + offset,
+                                   background_dma + offset,
+                                   (resolution_y - row0) * VIDEO_ROW_BYTES, 0);
+    if (tx == NULL)
+        return -EIO;
+    cookie = dmaengine_submit(tx);
+    if (dma_submit_error(cookie))
+        return -EIO;
+    if (dma_sync_wait(dma_chan, cookie) != DMA_COMPLETE)
+        return -EIO;
+    pixels_written += (resolution_y - row0) * resolution_x;
+    return 0;
+}
+
+// Function to copy the back buffer into the background cache
+void copy_to_background(void)
+{
+    int y;
+
+    if (dma_chan)
+        dma_sync_single_for_cpu(dma_chan->device->dev, background_dma, VIDEO_FRAME_BYTES,
+                                DMA_TO_DEVICE);
+    for (y = 0; y < resolution_y; y++)
+        memcpy_fromio(background + (y << 9), (void __iomem *)PIXEL_ADDRESS(0, y), resolution_x << 1);
+    if (dma_chan)
+        dma_sync_single_for_device(dma_chan->device->dev, background_dma, VIDEO_FRAME_BYTES,
+                                   DMA_TO_DEVICE);
+}
+
+// Function to restore the whole back buffer from the background cache with
+// the DMA engine, negative if there is none and the rows have to be copied
+int copy_from_background(void)
+{
+    if (dma_chan == NULL)
+        return -ENODEV;
+    return restore_rows_dma(0);
+}
+
+// Function to read the clock used for the command statistics
+u64 draw_now_ns(void)
+{
+    return ktime_get_ns();
+}
+
+// Register module functions
+module_init(start_video);
+module_exit(stop_video);
+
+MODULE_LICENSE("GPL");
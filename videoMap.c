@@ -0,0 +1,95 @@
+/*Direct user space rendering through the mmap()ed pixel buffers*/
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include "videoMap.h"
+
+#define MAP_BYTES (VIDEO_MAX_BUFFERS * VIDEO_FRAME_BYTES)
+#define ROW_PIXELS (VIDEO_ROW_BYTES / 2)
+#define SCREEN_WIDTH 320
+#define SCREEN_HEIGHT 240
+
+static void *map_base = NULL;
+
+int video_map(int video_FD) {
+    map_base = mmap(NULL, MAP_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, video_FD, 0);
+    if (map_base == MAP_FAILED) {
+        perror("Error mapping video buffers");
+        map_base = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void video_unmap(void) {
+    if (map_base) {
+        munmap(map_base, MAP_BYTES);
+        map_base = NULL;
+    }
+}
+
+// Function to turn a buffer index from the driver into a pointer
+static volatile uint16_t *buffer_address(int buffer) {
+    if (!map_base || buffer < 0 || buffer >= VIDEO_MAX_BUFFERS) {
+        return NULL;
+    }
+    return (volatile uint16_t *)((char *)map_base + buffer * VIDEO_FRAME_BYTES);
+}
+
+volatile uint16_t *video_back_buffer(int video_FD) {
+    int buffer;
+    if (ioctl(video_FD, VIDEO_IOC_GET_BACK, &buffer) == -1) {
+        perror("Failed to get back buffer");
+        return NULL;
+    }
+    return buffer_address(buffer);
+}
+
+volatile uint16_t *video_swap(int video_FD) {
+    int buffer;
+    if (ioctl(video_FD, VIDEO_IOC_SYNC, &buffer) == -1) {
+        perror("Failed to swap buffers");
+        return NULL;
+    }
+    return buffer_address(buffer);
+}
+
+int video_flip(int video_FD) {
+    if (ioctl(video_FD, VIDEO_IOC_FLIP) == -1) {
+        perror("Failed to request buffer swap");
+        return -1;
+    }
+    return 0;
+}
+
+int video_wait_flip(int video_FD, int timeout_ms) {
+    struct pollfd pfd = { .fd = video_FD, .events = POLLOUT };
+    int result = poll(&pfd, 1, timeout_ms);
+    if (result == -1) {
+        perror("Failed to poll video device");
+        return -1;
+    }
+    return result > 0 && (pfd.revents & POLLOUT);
+}
+
+void video_blit(volatile uint16_t *buffer, const unsigned short *data, int width, int height,
+                int x, int y, int key) {
+    int i, j;
+    // Work out the visible part of the sprite once
+    int col_start = (x < 0) ? -x : 0;
+    int col_end = (x + width > SCREEN_WIDTH) ? SCREEN_WIDTH - x : width;
+    int row_start = (y < 0) ? -y : 0;
+    int row_end = (y + height > SCREEN_HEIGHT) ? SCREEN_HEIGHT - y : height;
+
+    for (i = row_start; i < row_end; i++) {
+        const unsigned short *src = data + i * width;
+        volatile uint16_t *dst = buffer + (y + i) * ROW_PIXELS + x;
+        for (j = col_start; j < col_end; j++) {
+            if (src[j] != key) {
+                dst[j] = src[j];
+            }
+        }
+    }
+}
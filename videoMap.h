@@ -0,0 +1,30 @@
+#ifndef VIDEO_MAP_H
+#define VIDEO_MAP_H
+
+#include "video.h"
+
+// Function to map the driver's pixel buffers into this process, returns -1 on failure
+int video_map(int video_FD);
+
+// Function to unmap the pixel buffers
+void video_unmap(void);
+
+// Function to get the buffer that is currently safe to draw into
+volatile uint16_t *video_back_buffer(int video_FD);
+
+// Function to swap buffers and get the new back buffer
+volatile uint16_t *video_swap(int video_FD);
+
+// Function to request a swap and return immediately, returns -1 on failure
+int video_flip(int video_FD);
+
+// Function to wait up to timeout_ms (-1 for ever) for a requested swap to land,
+// returns 1 once the back buffer can be drawn into, 0 on timeout and -1 on error
+int video_wait_flip(int video_FD, int timeout_ms);
+
+// Function to copy a sprite into a buffer, skipping pixels equal to key
+// (pass -1 for an opaque sprite) and clipping to the screen
+void video_blit(volatile uint16_t *buffer, const unsigned short *data, int width, int height,
+                int x, int y, int key);
+
+#endif // VIDEO_MAP_H
@@ -0,0 +1,178 @@
+/*Simulated video device, runs the driver's drawing core in user space*/
+#define _POSIX_C_SOURCE 200809L // Needed for clock_gettime with -std=c99
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "videoSim.h"
+#include "videoDraw.h"
+
+#define ROW_PIXELS (VIDEO_ROW_BYTES / 2)
+#define CHAR_ROW_BYTES 128
+#define CHAR_ROWS 60
+
+static uint16_t *buffers[VIDEO_MAX_BUFFERS];
+static char *chars;
+static int num_buffers;
+static int front_buffer;
+
+// Commands are copied into an aligned buffer and NUL terminated, as in the driver
+static uint16_t command_words[VIDEO_BATCH_WORDS + 1];
+
+int sim_open(int count) {
+    int i;
+
+    if (count < 2 || count > VIDEO_MAX_BUFFERS) {
+        fprintf(stderr, "Unsupported number of buffers %d\n", count);
+        return -1;
+    }
+    num_buffers = count;
+    for (i = 0; i < num_buffers; i++) {
+        buffers[i] = calloc(1, VIDEO_FRAME_BYTES);
+        if (buffers[i] == NULL)
+            goto fail;
+    }
+    chars = calloc(CHAR_ROWS, CHAR_ROW_BYTES);
+    background = calloc(1, VIDEO_FRAME_BYTES);
+    if (chars == NULL || background == NULL)
+        goto fail;
+
+    resolution_x = SIM_WIDTH;
+    resolution_y = SIM_HEIGHT;
+    front_buffer = 0;
+    back_buffer = 1;
+    pixel_buffer = (unsigned long)buffers[back_buffer];
+    character_buffer = (unsigned long)chars;
+    background_valid = 0;
+    for (i = 0; i < VIDEO_MAX_BUFFERS; i++) {
+        dirty[i].count = 0;
+        dirty[i].full = 1;
+    }
+    return 0;
+
+fail:
+    perror("Error allocating simulated video buffers");
+    sim_close();
+    return -1;
+}
+
+void sim_close(void) {
+    int i;
+
+    for (i = 0; i < VIDEO_MAX_BUFFERS; i++) {
+        free(buffers[i]);
+        buffers[i] = NULL;
+    }
+    free(chars);
+    free(background);
+    chars = NULL;
+    background = NULL;
+}
+
+int sim_write(const void *buf, size_t len) {
+    char *command = (char *)command_words;
+    int result;
+
+    if (len > VIDEO_BATCH_BYTES) {
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(command, buf, len);
+    command[len] = '\0';
+
+    result = run_commands(command, len);
+    if (result < 0) {
+        errno = -result;
+        return -1;
+    }
+    return len;
+}
+
+int sim_front_buffer(void) {
+    return front_buffer;
+}
+
+int sim_back_buffer(void) {
+    return back_buffer;
+}
+
+const uint16_t *sim_pixels(int buffer) {
+    return buffers[buffer];
+}
+
+const char *sim_chars(void) {
+    return chars;
+}
+
+int sim_dump_ppm(const char *path, int buffer) {
+    FILE *f;
+    uint16_t p;
+    unsigned char rgb[3 * SIM_WIDTH];
+    int x, y;
+
+    f = fopen(path, "wb");
+    if (f == NULL) {
+        perror("Error opening image file");
+        return -1;
+    }
+
+    // Expand RGB565 to 8 bits per channel, repeating the top bits
+    fprintf(f, "P6\n%d %d\n255\n", SIM_WIDTH, SIM_HEIGHT);
+    for (y = 0; y < SIM_HEIGHT; y++) {
+        for (x = 0; x < SIM_WIDTH; x++) {
+            p = buffers[buffer][y * ROW_PIXELS + x];
+            rgb[3 * x] = ((p >> 11) << 3) | (p >> 13);
+            rgb[3 * x + 1] = (((p >> 5) & 0x3F) << 2) | ((p >> 9) & 0x03);
+            rgb[3 * x + 2] = ((p & 0x1F) << 3) | ((p >> 2) & 0x07);
+        }
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+    return fclose(f);
+}
+
+void sim_dump_text(FILE *f) {
+    int x, y;
+    char c;
+
+    for (y = 0; y < CHAR_ROWS; y++) {
+        for (x = 0; x < char_resolution_x; x++) {
+            c = chars[y * CHAR_ROW_BYTES + x];
+            fputc((c >= ' ' && c <= '~') ? c : ' ', f);
+        }
+        fputc('\n', f);
+    }
+}
+
+// Backend functions used by the drawing core
+
+// There is always a free buffer, since swaps land at once
+int wait_for_back_buffer(void) {
+    return 0;
+}
+
+// Function to show the back buffer and move on to the next one
+int request_flip(void) {
+    front_buffer = back_buffer;
+    back_buffer = (back_buffer + 1) % num_buffers;
+    pixel_buffer = (unsigned long)buffers[back_buffer];
+    return 0;
+}
+
+void copy_to_background(void) {
+    int y;
+
+    for (y = 0; y < resolution_y; y++)
+        memcpy(background + y * ROW_PIXELS, (void *)PIXEL_ADDRESS(0, y), resolution_x * 2);
+}
+
+// No DMA engine here, the core copies the rows itself like the driver does without one
+int copy_from_background(void) {
+    return -1;
+}
+
+u64 draw_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
@@ -0,0 +1,43 @@
+// videoSim.h
+// In-memory stand-in for /dev/video. The drawing core of the driver
+// (videoDraw.c) runs against 512x256 RGB565 pixel buffers and an 80x60
+// character buffer in ordinary memory, so the renderer can be run,
+// benchmarked and checked on any Linux machine. Buffer swaps land at once.
+#ifndef VIDEO_SIM_H
+#define VIDEO_SIM_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "video.h"
+
+#define SIM_WIDTH 320
+#define SIM_HEIGHT 240
+
+// Function to allocate num_buffers (2 or 3) pixel buffers and the character
+// buffer, all cleared to zero, returns -1 on failure
+int sim_open(int num_buffers);
+
+// Function to free everything allocated by sim_open
+void sim_close(void);
+
+// Function to run commands exactly as a write() to /dev/video would,
+// returns len, or -1 with errno set
+int sim_write(const void *buf, size_t len);
+
+// Function to get the buffer being shown and the one being drawn into
+int sim_front_buffer(void);
+int sim_back_buffer(void);
+
+// Function to get a pixel buffer, rows are VIDEO_ROW_BYTES apart
+const uint16_t *sim_pixels(int buffer);
+
+// Function to get the character buffer, rows are 128 bytes apart
+const char *sim_chars(void);
+
+// Function to write a pixel buffer as a binary PPM image, returns -1 on failure
+int sim_dump_ppm(const char *path, int buffer);
+
+// Function to write the character buffer as 60 lines of text
+void sim_dump_text(FILE *f);
+
+#endif // VIDEO_SIM_H